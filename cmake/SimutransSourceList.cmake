@@ -27,6 +27,7 @@ target_sources(simutrans PRIVATE
 		src/simutrans/dataobj/scenario.cc
 		src/simutrans/dataobj/schedule.cc
 		src/simutrans/dataobj/settings.cc
+		src/simutrans/dataobj/step_arena.cc
 		src/simutrans/dataobj/sve_cache.cc
 		src/simutrans/dataobj/tabfile.cc
 		src/simutrans/dataobj/translator.cc
@@ -184,6 +185,7 @@ target_sources(simutrans PRIVATE
 		src/simutrans/gui/pakinstaller.cc
 		src/simutrans/gui/pakselector.cc
 		src/simutrans/gui/password_frame.cc
+		src/simutrans/gui/perf_frame.cc
 		src/simutrans/gui/player_frame.cc
 		src/simutrans/gui/player_ranking_frame.cc
 		src/simutrans/gui/privatesign_info.cc
@@ -214,6 +216,7 @@ target_sources(simutrans PRIVATE
 		src/simutrans/io/rdwr/adler32_stream.cc
 		src/simutrans/io/rdwr/bzip2_file_rdwr_stream.cc
 		src/simutrans/io/rdwr/compare_file_rd_stream.cc
+		src/simutrans/io/rdwr/memory_rdwr_stream.cc
 		src/simutrans/io/rdwr/raw_file_rdwr_stream.cc
 		src/simutrans/io/rdwr/rdwr_stream.cc
 		src/simutrans/io/rdwr/zlib_file_rdwr_stream.cc
@@ -292,6 +295,7 @@ target_sources(simutrans PRIVATE
 		src/simutrans/script/export_objs.cc
 		src/simutrans/script/script.cc
 		src/simutrans/script/script_loader.cc
+		src/simutrans/script/script_profiler.cc
 		src/simutrans/script/script_tool_manager.cc
 		src/simutrans/simachievements.cc
 		src/simutrans/simconvoi.cc
@@ -320,6 +324,7 @@ target_sources(simutrans PRIVATE
 		src/simutrans/utils/checklist.cc
 		src/simutrans/utils/csv.cc
 		src/simutrans/utils/log.cc
+		src/simutrans/utils/perf_timer.cc
 		src/simutrans/utils/searchfolder.cc
 		src/simutrans/utils/sha1.cc
 		src/simutrans/utils/sha1_hash.cc
@@ -81,6 +81,8 @@ karte_ptr_t way_builder_t::welt;
 
 const way_desc_t *way_builder_t::leitung_desc = NULL;
 
+way_search_context_t way_builder_t::main_search_context;
+
 static stringhashtable_tpl <const way_desc_t *> desc_table;
 
 
@@ -1274,11 +1276,16 @@ way_builder_t::way_builder_t(player_t* player)
 	: next_gr(32)
 	, player_builder(player)
 	, bautyp(strasse) // kann mit init_builder() gesetzt werden
+	, desc(NULL)
+	, bridge_desc(NULL)
+	, tunnel_desc(NULL)
 	, keep_existing_ways(false)
 	, keep_existing_faster_ways(false)
 	, keep_existing_city_roads(false)
 	, build_sidewalk(false)
 	, prefer_parallel(false)
+	, search_context(&main_search_context)
+	, bidirectional(false)
 {
 	maximum = welt->get_settings().way_count_maximum; // building cost, (curves etc.)
 }
@@ -1339,6 +1346,102 @@ void way_builder_t::init_builder(bautyp_t wt, const way_desc_t *b, const tunnel_
 }
 
 
+// nodes per block of the pool of a way_search_context_t
+#define SEARCH_NODE_BLOCK (65536)
+
+
+way_search_context_t::way_search_context_t() :
+	max_nodes(0),
+	used_nodes(0)
+{
+	for(  int i=0;  i<2;  i++  ) {
+		closed[i] = NULL;
+		closed_size[i] = 0;
+		closed_count[i] = 0;
+	}
+}
+
+
+way_search_context_t::~way_search_context_t()
+{
+	for(route_t::ANode *block : blocks) {
+		delete [] block;
+	}
+	delete [] closed[0];
+	delete [] closed[1];
+}
+
+
+void way_search_context_t::init(uint32 steps, sint16 size_x, sint16 size_y)
+{
+	max_nodes = steps;
+	used_nodes = 0;
+	for(  int i=0;  i<2;  i++  ) {
+		queue[i].clear();
+		marker[i].init(size_x, size_y);
+		if(  closed_count[i] > 0  ) {
+			memset( closed[i], 0, sizeof(route_t::ANode *) * closed_size[i] );
+			closed_count[i] = 0;
+		}
+	}
+}
+
+
+route_t::ANode *way_search_context_t::get_node()
+{
+	if(  used_nodes >= max_nodes  ) {
+		return NULL;
+	}
+	const uint32 block = used_nodes / SEARCH_NODE_BLOCK;
+	if(  block == blocks.get_count()  ) {
+		blocks.append( new route_t::ANode[SEARCH_NODE_BLOCK] );
+	}
+	return &blocks[block][used_nodes++ % SEARCH_NODE_BLOCK];
+}
+
+
+void way_search_context_t::add_closed(int side, route_t::ANode *node)
+{
+	if(  2*(closed_count[side]+1) > closed_size[side]  ) {
+		// keep it at most half full
+		route_t::ANode **old = closed[side];
+		const uint32 old_size = closed_size[side];
+		closed_size[side] = max( 4096u, 2*old_size );
+		closed[side] = new route_t::ANode *[closed_size[side]];
+		memset( closed[side], 0, sizeof(route_t::ANode *) * closed_size[side] );
+		closed_count[side] = 0;
+		for(  uint32 i=0;  i<old_size;  i++  ) {
+			if(  old[i]  ) {
+				add_closed( side, old[i] );
+			}
+		}
+		delete [] old;
+	}
+	const uint32 mask = closed_size[side]-1;
+	uint32 i = hash( node->gr ) & mask;
+	while(  closed[side][i]  ) {
+		i = (i+1) & mask;
+	}
+	closed[side][i] = node;
+	closed_count[side]++;
+}
+
+
+route_t::ANode *way_search_context_t::get_closed(int side, const grund_t *gr) const
+{
+	if(  closed_count[side] == 0  ) {
+		return NULL;
+	}
+	const uint32 mask = closed_size[side]-1;
+	for(  uint32 i = hash( gr ) & mask;  closed[side][i];  i = (i+1) & mask  ) {
+		if(  closed[side][i]->gr == gr  ) {
+			return closed[side][i];
+		}
+	}
+	return NULL;
+}
+
+
 static void get_mini_maxi( const vector_tpl<koord3d> &ziel, koord3d &mini, koord3d &maxi )
 {
 	mini = maxi = ziel[0];
@@ -1353,6 +1456,210 @@ static void get_mini_maxi( const vector_tpl<koord3d> &ziel, koord3d &mini, koord
 }
 
 
+bool way_builder_t::init_route_search(const vector_tpl<koord3d> &start, binary_heap_tpl<route_t::ANode *> &queue, const koord3d &mini, const koord3d &maxi, uint8 flags)
+{
+	for(koord3d const& i : start) {
+		const grund_t *gr = welt->lookup(i);
+
+		// is valid ground?
+		sint32 dummy;
+		if( !gr || !is_allowed_step(gr,gr,&dummy) ) {
+			// DBG_MESSAGE("way_builder_t::intern_calc_route()","cannot start on (%i,%i,%i)",start.x,start.y,start.z);
+			continue;
+		}
+		route_t::ANode *tmp = search_context->get_node();
+		if(  tmp==NULL  ) {
+			break;
+		}
+
+		tmp->parent = NULL;
+		tmp->gr = gr;
+		tmp->f = calc_distance(i, mini, maxi);
+		tmp->g = 0;
+		tmp->dir = 0;
+		tmp->count = flags;
+
+		queue.insert(tmp);
+	}
+	return !queue.empty();
+}
+
+
+uint32 way_builder_t::calc_curve_cost(const route_t::ANode *node, const grund_t *to, uint8 &dir) const
+{
+	settings_t const& s = welt->get_settings();
+	uint32 cost = 0;
+	dir = ribi_type( node->parent->gr->get_pos(), to->get_pos() );
+	if(node->dir!=dir) {
+		cost += s.way_count_curve;
+		if(node->parent->dir!=node->dir) {
+			// discourage double turns
+			cost += s.way_count_double_curve;
+		}
+		else if(ribi_t::is_perpendicular(node->dir,dir)) {
+			// discourage v turns heavily
+			cost += s.way_count_90_curve;
+		}
+	}
+	else if(bautyp==leitung  &&  ribi_t::is_bend(dir)) {
+		cost += s.way_count_double_curve;
+	}
+	// extra malus leave an existing road after only one tile
+	waytype_t const wt = desc->get_wtyp();
+	if (node->parent->gr->hat_weg(wt) && !node->gr->hat_weg(wt) && to->hat_weg(wt)) {
+		// but only if not straight track
+		if(!ribi_t::is_straight(node->dir)) {
+			cost += s.way_count_leaving_way;
+		}
+	}
+	return cost;
+}
+
+
+bool way_builder_t::expand_route_node(route_t::ANode *tmp, binary_heap_tpl<route_t::ANode *> &queue, const marker_t &marker, const vector_tpl<koord3d> &ziel, const koord3d &mini, const koord3d &maxi, uint32 &min_dist, bool allow_terraform)
+{
+	const grund_t *gr = tmp->gr;
+	grund_t *to;
+
+	// the four possible directions plus any additional stuff due to already existing brides plus new ones ...
+	next_gr.clear();
+
+	// only one direction allowed ...
+	const ribi_t::ribi straight_dir = tmp->parent!=NULL ? ribi_type(gr->get_pos() - tmp->parent->gr->get_pos()) : (ribi_t::ribi)ribi_t::all;
+
+	// test directions
+	// .. use only those that are allowed by current slope
+	// .. do not go backward
+	const ribi_t::ribi slope_dir = (slope_t::is_way_ns(gr->get_weg_hang()) ? ribi_t::northsouth : ribi_t::none) | (slope_t::is_way_ew(gr->get_weg_hang()) ? ribi_t::eastwest : ribi_t::none);
+	const ribi_t::ribi test_dir = (tmp->count & build_straight)==0  ?  slope_dir  & ~ribi_t::backward(straight_dir)
+	                                                                :  straight_dir;
+
+	// testing all four possible directions
+	for(ribi_t::ribi r=1; (r&16)==0; r<<=1) {
+		if((r & test_dir)==0) {
+			// not allowed to go this direction
+			continue;
+		}
+
+		bool do_terraform = false;
+		const koord zv(r);
+		if(!gr->get_neighbour(to,invalid_wt,r)  ||  !check_slope(gr, to)) {
+			// slopes do not match
+			// terraforming enabled?
+			if (bautyp==river  ||  (bautyp & terraform_flag) == 0  ||  !allow_terraform) {
+				continue;
+			}
+			// check terraforming (but not in curves)
+			if (gr->get_grund_hang()==0  ||  (tmp->parent!=NULL  &&  tmp->parent->parent!=NULL  &&  r==straight_dir)) {
+				to = welt->lookup_kartenboden(gr->get_pos().get_2d() + zv);
+				if (to==NULL  ||  (check_slope(gr, to)  &&  gr->get_vmove(r)!=to->get_vmove(ribi_t::backward(r)))) {
+					continue;
+				}
+				else {
+					do_terraform = true;
+				}
+			}
+			else {
+				continue;
+			}
+		}
+
+		// something valid?
+		if(marker.is_marked(to)) {
+			continue;
+		}
+
+		sint32 new_cost = 0;
+		bool is_ok = is_allowed_step(gr,to,&new_cost);
+
+		if(is_ok) {
+			// now add it to the array ...
+			next_gr.append(next_gr_t(to, new_cost, do_terraform ? build_straight | terraform : 0));
+		}
+		else if(tmp->parent!=NULL  &&  r==straight_dir  &&  (tmp->count & build_tunnel_bridge)==0) {
+			// try to build a bridge or tunnel here, since we cannot go here ...
+			check_for_bridge(tmp->parent->gr,gr,ziel);
+		}
+	}
+
+	// now check all valid ones ...
+	for(next_gr_t const& r : next_gr) {
+		to = r.gr;
+
+		if(  to==NULL) {
+			continue;
+		}
+
+		// new values for cost g
+		uint32 new_g = tmp->g + r.cost;
+
+		settings_t const& s = welt->get_settings();
+		// check for curves (usually, one would need the lastlast and the last;
+		// if not there, then we could just take the last
+		uint8 current_dir;
+		if(tmp->parent!=NULL) {
+			new_g += calc_curve_cost( tmp, to, current_dir );
+		}
+		else {
+			 current_dir = ribi_type( gr->get_pos(), to->get_pos() );
+		}
+
+		const uint32 new_dist = calc_distance( to->get_pos(), mini, maxi );
+
+		// special check for kinks at the end
+		if(new_dist==0  &&  current_dir!=tmp->dir) {
+			// discourage turn on last tile
+			new_g += s.way_count_double_curve;
+		}
+
+		if (new_dist == 0 && r.flag & terraform) {
+			// no terraforming near target
+			continue;
+		}
+		if(new_dist<min_dist) {
+			min_dist = new_dist;
+		}
+		else if(new_dist>min_dist+50) {
+			// skip, if too far from current minimum tile
+			// will not find some ways, but will be much faster ...
+			// also it will avoid too big detours, which is probably also not the way, the builder intended
+			continue;
+		}
+
+
+		const uint32 new_f = new_g+new_dist;
+
+		if((search_context->get_used_nodes()&0x03)==0) {
+			INT_CHECK( "wegbauer 1347" );
+#ifdef DEBUG_ROUTES
+			if((search_context->get_used_nodes()&1023)==0) {minimap_t::get_instance()->calc_map();}
+#endif
+		}
+
+		// not in there or taken out => add new
+		route_t::ANode *k = search_context->get_node();
+		if(  k==NULL  ) {
+			return false;
+		}
+
+		k->parent = tmp;
+		k->gr = to;
+		k->g = new_g;
+		k->f = new_f;
+		k->dir = current_dir;
+		// count is unused here, use it as flag-variable instead
+		k->count = r.flag | (tmp->count & backward_node);
+
+		queue.insert( k );
+
+#ifdef DEBUG_ROUTES
+DBG_DEBUG("insert to open","(%i,%i,%i)  f=%i",to->get_pos().x,to->get_pos().y,to->get_pos().z,k->f);
+#endif
+	}
+	return true;
+}
+
+
 /**
  * this routine uses A* to calculate the best route
  * beware: change the cost and you will mess up the system!
@@ -1379,58 +1686,22 @@ sint32 way_builder_t::intern_calc_route(const vector_tpl<koord3d> &start, const
 	koord3d mini, maxi;
 	get_mini_maxi( ziel, mini, maxi );
 
-	// memory in static list ...
-	if(route_t::nodes==NULL) {
-		route_t::MAX_STEP = welt->get_settings().get_max_route_steps(); // may need very much memory => configurable
-		route_t::nodes = new route_t::ANode[route_t::MAX_STEP+4+1];
-	}
-
-	static binary_heap_tpl <route_t::ANode *> queue;
-
-	// initialize marker field
-	marker_t& marker = marker_t::instance(welt->get_size().x, welt->get_size().y);
-
-	// clear the queue (should be empty anyhow)
-	queue.clear();
-
-	// some thing for the search
-	grund_t *to;
-	koord3d gr_pos; // just the last valid pos ...
-	route_t::ANode *tmp=NULL;
-	uint32 step = 0;
-	const grund_t* gr=NULL;
-
-	for(koord3d const& i : start) {
-		gr = welt->lookup(i);
+	// clear the lists (memory stays allocated in the context)
+	search_context->init( welt->get_settings().get_max_route_steps(), welt->get_size().x, welt->get_size().y ); // may need very much memory => configurable
+	binary_heap_tpl<route_t::ANode *> &queue = search_context->queue[0];
+	marker_t &marker = search_context->marker[0];
 
-		// is valid ground?
-		sint32 dummy;
-		if( !gr || !is_allowed_step(gr,gr,&dummy) ) {
-			// DBG_MESSAGE("way_builder_t::intern_calc_route()","cannot start on (%i,%i,%i)",start.x,start.y,start.z);
-			continue;
-		}
-		tmp = &(route_t::nodes[step]);
-		step ++;
-
-		tmp->parent = NULL;
-		tmp->gr = gr;
-		tmp->f = calc_distance(i, mini, maxi);
-		tmp->g = 0;
-		tmp->dir = 0;
-		tmp->count = 0;
-
-		queue.insert(tmp);
-	}
-
-	if( queue.empty() ) {
+	if(  !init_route_search( start, queue, mini, maxi, 0 )  ) {
 		// no valid ground to start.
 		return -1;
 	}
 
 	INT_CHECK("wegbauer 347");
 
-	// get exclusively the tile list
-	route_t::GET_NODE();
+	// some thing for the search
+	route_t::ANode *tmp=NULL;
+	const grund_t* gr=NULL;
+	bool pool_exhausted = false;
 
 	// to speed up search, but may not find all shortest ways
 	uint32 min_dist = 99999999;
@@ -1447,202 +1718,179 @@ sint32 way_builder_t::intern_calc_route(const vector_tpl<koord3d> &start, const
 
 		tmp = test_tmp;
 		gr = tmp->gr;
-		gr_pos = gr->get_pos();
 
 #ifdef DEBUG_ROUTES
 DBG_DEBUG("insert to close","(%i,%i,%i)  f=%i",gr->get_pos().x,gr->get_pos().y,gr->get_pos().z,tmp->f);
 #endif
 
 		// already there
-		if(  ziel.is_contained(gr_pos)  ||  tmp->g>maximum) {
+		if(  ziel.is_contained(gr->get_pos())  ||  tmp->g>maximum) {
 			// we added a target to the closed list: we are finished
 			break;
 		}
 
-		// the four possible directions plus any additional stuff due to already existing brides plus new ones ...
-		next_gr.clear();
-
-		// only one direction allowed ...
-		const ribi_t::ribi straight_dir = tmp->parent!=NULL ? ribi_type(gr->get_pos() - tmp->parent->gr->get_pos()) : (ribi_t::ribi)ribi_t::all;
-
-		// test directions
-		// .. use only those that are allowed by current slope
-		// .. do not go backward
-		const ribi_t::ribi slope_dir = (slope_t::is_way_ns(gr->get_weg_hang()) ? ribi_t::northsouth : ribi_t::none) | (slope_t::is_way_ew(gr->get_weg_hang()) ? ribi_t::eastwest : ribi_t::none);
-		const ribi_t::ribi test_dir = (tmp->count & build_straight)==0  ?  slope_dir  & ~ribi_t::backward(straight_dir)
-		                                                                :  straight_dir;
-
-		// testing all four possible directions
-		for(ribi_t::ribi r=1; (r&16)==0; r<<=1) {
-			if((r & test_dir)==0) {
-				// not allowed to go this direction
-				continue;
-			}
-
-			bool do_terraform = false;
-			const koord zv(r);
-			if(!gr->get_neighbour(to,invalid_wt,r)  ||  !check_slope(gr, to)) {
-				// slopes do not match
-				// terraforming enabled?
-				if (bautyp==river  ||  (bautyp & terraform_flag) == 0) {
-					continue;
-				}
-				// check terraforming (but not in curves)
-				if (gr->get_grund_hang()==0  ||  (tmp->parent!=NULL  &&  tmp->parent->parent!=NULL  &&  r==straight_dir)) {
-					to = welt->lookup_kartenboden(gr->get_pos().get_2d() + zv);
-					if (to==NULL  ||  (check_slope(gr, to)  &&  gr->get_vmove(r)!=to->get_vmove(ribi_t::backward(r)))) {
-						continue;
-					}
-					else {
-						do_terraform = true;
-					}
-				}
-				else {
-					continue;
-				}
-			}
+		pool_exhausted = !expand_route_node( tmp, queue, marker, ziel, mini, maxi, min_dist, true );
 
-			// something valid?
-			if(marker.is_marked(to)) {
-				continue;
-			}
+	} while (!queue.empty() && !pool_exhausted);
 
-			sint32 new_cost = 0;
-			bool is_ok = is_allowed_step(gr,to,&new_cost);
+#ifdef DEBUG_ROUTES
+DBG_DEBUG("way_builder_t::intern_calc_route()","steps=%i  (max %i) in route, open %i, cost %u",search_context->get_used_nodes(),search_context->get_max_nodes(),queue.get_count(),tmp->g);
+#endif
+	INT_CHECK("wegbauer 194");
 
-			if(is_ok) {
-				// now add it to the array ...
-				next_gr.append(next_gr_t(to, new_cost, do_terraform ? build_straight | terraform : 0));
-			}
-			else if(tmp->parent!=NULL  &&  r==straight_dir  &&  (tmp->count & build_tunnel_bridge)==0) {
-				// try to build a bridge or tunnel here, since we cannot go here ...
-				check_for_bridge(tmp->parent->gr,gr,ziel);
+	// target reached?
+	if(  !ziel.is_contained(gr->get_pos())  ||  pool_exhausted  ||  tmp->parent==NULL  ||  tmp->g > maximum  ) {
+		if (pool_exhausted) {
+			dbg->warning("way_builder_t::intern_calc_route()","Too many steps (%i>=max %i) in route (too long/complex)",search_context->get_used_nodes(),search_context->get_max_nodes());
+		}
+		return -1;
+	}
+	else {
+		const sint32 cost = tmp->g;
+		// reached => construct route
+		while(tmp != NULL) {
+			route.append(tmp->gr->get_pos());
+			if (tmp->count & terraform) {
+				terraform_index.append(route.get_count()-1);
 			}
+			tmp = tmp->parent;
 		}
+		return cost;
+	}
+}
 
-		// now check all valid ones ...
-		for(next_gr_t const& r : next_gr) {
-			to = r.gr;
-
-			if(  to==NULL) {
-				continue;
-			}
 
-			// new values for cost g
-			uint32 new_g = tmp->g + r.cost;
+/**
+ * Two searches like intern_calc_route, one starting at @p start and one at @p ziel.
+ * Always the one with the smaller open list is advanced. When one takes a tile
+ * the other has already closed, both halves are joined there, if the way can
+ * pass straight or in a curve through this tile. The backward half may not
+ * terraform, since do_terraforming expects the tiles in the order of a forward search.
+ */
+sint32 way_builder_t::intern_calc_route_bidirectional(const vector_tpl<koord3d> &start, const vector_tpl<koord3d> &ziel)
+{
+	assert((get_random_mode() & SYNC_STEP_RANDOM) == 0);
 
-			settings_t const& s = welt->get_settings();
-			// check for curves (usually, one would need the lastlast and the last;
-			// if not there, then we could just take the last
-			uint8 current_dir;
-			if(tmp->parent!=NULL) {
-				current_dir = ribi_type( tmp->parent->gr->get_pos(), to->get_pos() );
-				if(tmp->dir!=current_dir) {
-					new_g += s.way_count_curve;
-					if(tmp->parent->dir!=tmp->dir) {
-						// discourage double turns
-						new_g += s.way_count_double_curve;
-					}
-					else if(ribi_t::is_perpendicular(tmp->dir,current_dir)) {
-						// discourage v turns heavily
-						new_g += s.way_count_90_curve;
-					}
-				}
-				else if(bautyp==leitung  &&  ribi_t::is_bend(current_dir)) {
-					new_g += s.way_count_double_curve;
-				}
-				// extra malus leave an existing road after only one tile
-				waytype_t const wt = desc->get_wtyp();
-				if (tmp->parent->gr->hat_weg(wt) && !gr->hat_weg(wt) && to->hat_weg(wt)) {
-					// but only if not straight track
-					if(!ribi_t::is_straight(tmp->dir)) {
-						new_g += s.way_count_leaving_way;
-					}
-				}
-			}
-			else {
-				 current_dir = ribi_type( gr->get_pos(), to->get_pos() );
-			}
+	route.clear();
+	terraform_index.clear();
 
-			const uint32 new_dist = calc_distance( to->get_pos(), mini, maxi );
+	search_context->init( welt->get_settings().get_max_route_steps(), welt->get_size().x, welt->get_size().y );
 
-			// special check for kinks at the end
-			if(new_dist==0  &&  current_dir!=tmp->dir) {
-				// discourage turn on last tile
-				new_g += s.way_count_double_curve;
-			}
+	// side 0 searches from start to ziel, side 1 from ziel to start
+	const vector_tpl<koord3d> *targets[2] = { &ziel, &start };
+	koord3d mini[2], maxi[2];
+	get_mini_maxi( ziel, mini[0], maxi[0] );
+	get_mini_maxi( start, mini[1], maxi[1] );
+	uint32 min_dist[2] = { 99999999, 99999999 };
 
-			if (new_dist == 0 && r.flag & terraform) {
-				// no terraforming near target
-				continue;
-			}
-			if(new_dist<min_dist) {
-				min_dist = new_dist;
-			}
-			else if(new_dist>min_dist+50) {
-				// skip, if too far from current minimum tile
-				// will not find some ways, but will be much faster ...
-				// also it will avoid too big detours, which is probably also not the way, the builder intended
-				continue;
-			}
+	// the successors inherit the backward flag of the starting nodes
+	if(  !init_route_search( start, search_context->queue[0], mini[0], maxi[0], 0 )  ||  !init_route_search( ziel, search_context->queue[1], mini[1], maxi[1], backward_node )  ) {
+		return -1;
+	}
 
+	INT_CHECK("wegbauer 347");
 
-			const uint32 new_f = new_g+new_dist;
+	// the nodes on the meeting tile (or a single node on a target tile)
+	route_t::ANode *meet[2] = { NULL, NULL };
+	bool pool_exhausted = false;
 
-			if((step&0x03)==0) {
-				INT_CHECK( "wegbauer 1347" );
-#ifdef DEBUG_ROUTES
-				if((step&1023)==0) {minimap_t::get_instance()->calc_map();}
-#endif
-			}
+	while(  !search_context->queue[0].empty()  &&  !search_context->queue[1].empty()  &&  !pool_exhausted  ) {
+		const int side = search_context->queue[0].get_count() <= search_context->queue[1].get_count() ? 0 : 1;
+		const int other = 1-side;
 
-			// not in there or taken out => add new
-			route_t::ANode *k=&(route_t::nodes[step]);
-			step++;
+		route_t::ANode *tmp = search_context->queue[side].pop();
+		if(  search_context->marker[side].test_and_mark(tmp->gr)  ) {
+			continue;
+		}
+		search_context->add_closed( side, tmp );
 
-			k->parent = tmp;
-			k->gr = to;
-			k->g = new_g;
-			k->f = new_f;
-			k->dir = current_dir;
-			// count is unused here, use it as flag-variable instead
-			k->count = r.flag;
+		if(  tmp->g > maximum  ) {
+			break;
+		}
 
-			queue.insert( k );
+		if(  targets[side]->is_contained(tmp->gr->get_pos())  ) {
+			// reached the other end on our own
+			meet[side] = tmp;
+			break;
+		}
 
-#ifdef DEBUG_ROUTES
-DBG_DEBUG("insert to open","(%i,%i,%i)  f=%i",to->get_pos().x,to->get_pos().y,to->get_pos().z,k->f);
-#endif
+		if(  search_context->marker[other].is_marked(tmp->gr)  ) {
+			route_t::ANode *other_node = search_context->get_closed( other, tmp->gr );
+			if(  other_node  &&  tmp->g + other_node->g <= maximum  ) {
+				// can we pass this tile between both parent tiles?
+				const ribi_t::ribi slope_dir = (slope_t::is_way_ns(tmp->gr->get_weg_hang()) ? ribi_t::northsouth : ribi_t::none) | (slope_t::is_way_ew(tmp->gr->get_weg_hang()) ? ribi_t::eastwest : ribi_t::none);
+				const ribi_t::ribi dir_in = tmp->parent ? ribi_type( tmp->parent->gr->get_pos(), tmp->gr->get_pos() ) : (ribi_t::ribi)ribi_t::none;
+				const ribi_t::ribi dir_out = other_node->parent ? ribi_type( tmp->gr->get_pos(), other_node->parent->gr->get_pos() ) : (ribi_t::ribi)ribi_t::none;
+				bool can_join = ((dir_in | dir_out) & ~slope_dir) == 0  &&  (tmp->count & other_node->count & terraform) == 0;
+				if(  dir_in  &&  dir_out  ) {
+					can_join &= dir_out != ribi_t::backward(dir_in);
+					can_join &= ((tmp->count | other_node->count) & build_straight) == 0  ||  dir_in == dir_out;
+				}
+				if(  can_join  ) {
+					meet[side] = tmp;
+					meet[other] = other_node;
+					break;
+				}
+			}
 		}
 
-	} while (!queue.empty() && step < route_t::MAX_STEP);
+		pool_exhausted = !expand_route_node( tmp, search_context->queue[side], search_context->marker[side], *targets[side], mini[side], maxi[side], min_dist[side], side==0 );
+	}
 
-#ifdef DEBUG_ROUTES
-DBG_DEBUG("way_builder_t::intern_calc_route()","steps=%i  (max %i) in route, open %i, cost %u",step,route_t::MAX_STEP,queue.get_count(),tmp->g);
-#endif
 	INT_CHECK("wegbauer 194");
 
-	route_t::RELEASE_NODE();
-
-	// target reached?
-	if(  !ziel.is_contained(gr->get_pos())  ||  step>=route_t::MAX_STEP  ||  tmp->parent==NULL  ||  tmp->g > maximum  ) {
-		if (step>=route_t::MAX_STEP) {
-			dbg->warning("way_builder_t::intern_calc_route()","Too many steps (%i>=max %i) in route (too long/complex)",step,route_t::MAX_STEP);
+	if(  meet[0]==NULL  &&  meet[1]==NULL  ) {
+		if (pool_exhausted) {
+			dbg->warning("way_builder_t::intern_calc_route_bidirectional()","Too many steps (%i>=max %i) in route (too long/complex)",search_context->get_used_nodes(),search_context->get_max_nodes());
 		}
 		return -1;
 	}
-	else {
-		const sint32 cost = tmp->g;
-		// reached => construct route
-		while(tmp != NULL) {
-			route.append(tmp->gr->get_pos());
-			if (tmp->count & terraform) {
-				terraform_index.append(route.get_count()-1);
+
+	// the route runs from ziel (index 0) to start, like the one of intern_calc_route
+	sint32 cost = 0;
+	if(  meet[0]  &&  meet[1]  ) {
+		// both halves paid for entering the meeting tile, but not for the turn there
+		sint32 entry_cost = 0;
+		if(  meet[1]->parent  &&  is_allowed_step( meet[1]->parent->gr, meet[1]->gr, &entry_cost )  ) {
+			cost -= entry_cost;
+		}
+		if(  meet[0]->parent  &&  meet[1]->parent  ) {
+			uint8 dummy_dir;
+			cost += calc_curve_cost( meet[0], meet[1]->parent->gr, dummy_dir );
+		}
+	}
+	if(  meet[1]  ) {
+		cost += meet[1]->g;
+		vector_tpl<route_t::ANode *> backward_half;
+		for(  route_t::ANode *tmp = meet[1];  tmp;  tmp = tmp->parent  ) {
+			backward_half.append(tmp);
+		}
+		for(  uint32 i = backward_half.get_count();  i-- > 0;  ) {
+			route.append( backward_half[i]->gr->get_pos() );
+		}
+	}
+	if(  meet[0]  ) {
+		cost += meet[0]->g;
+		// the meeting tile is already in the route
+		uint32 index = route.get_count();
+		if(  index > 0  ) {
+			index --;
+		}
+		for(  route_t::ANode *tmp = meet[0];  tmp;  tmp = tmp->parent, index++  ) {
+			if(  index == route.get_count()  ) {
+				route.append( tmp->gr->get_pos() );
+			}
+			if(  tmp->count & terraform  ) {
+				terraform_index.append(index);
 			}
-			tmp = tmp->parent;
 		}
-		return cost;
 	}
+
+	if(  route.get_count() < 2  ) {
+		route.clear();
+		return -1;
+	}
+	return cost;
 }
 
 
@@ -1844,26 +2092,17 @@ sint32 way_builder_t::intern_calc_route_elevated(const koord3d start, const koor
 		return -1;
 	}
 
-	// memory in static list ...
-	if(route_t::nodes==NULL) {
-		route_t::MAX_STEP = welt->get_settings().get_max_route_steps(); // may need very much memory => configurable
-		route_t::nodes = new route_t::ANode[route_t::MAX_STEP+4+1];
-	}
-
-	static binary_heap_tpl <route_t::ANode *> queue;
-
-	// initialize marker field
-	marker_t& markerbelow = marker_t::instance(welt->get_size().x, welt->get_size().y);
-	marker_t& markerabove = marker_t::instance_second(welt->get_size().x, welt->get_size().y);
-
-	// clear the queue (should be empty anyhow)
-	queue.clear();
+	// clear the lists (memory stays allocated in the context)
+	search_context->init( welt->get_settings().get_max_route_steps(), welt->get_size().x, welt->get_size().y ); // may need very much memory => configurable
+	binary_heap_tpl<route_t::ANode *> &queue = search_context->queue[0];
+	marker_t &markerbelow = search_context->marker[0];
+	marker_t &markerabove = search_context->marker[1];
 
 	// some thing for the search
 	grund_t *to;
 	koord3d gr_pos; // just the last valid pos ...
 	route_t::ANode *tmp=NULL;
-	uint32 step = 0;
+	bool pool_exhausted = false;
 	const grund_t *gr=NULL, *gu = NULL;
 
 	gr = welt->lookup(start);
@@ -1871,8 +2110,7 @@ sint32 way_builder_t::intern_calc_route_elevated(const koord3d start, const koor
 	sint32 dummy;
 	if( gr && is_allowed_step(gr,gr,&dummy) ) {
 		// DBG_MESSAGE("way_builder_t::intern_calc_route()","cannot start on (%i,%i,%i)",start.x,start.y,start.z);
-		tmp = &(route_t::nodes[step]);
-		step ++;
+		tmp = search_context->get_node();
 		tmp->parent = NULL;
 		tmp->gr = gr;
 		tmp->f = calc_distance(start, ziel, ziel);
@@ -1887,8 +2125,7 @@ sint32 way_builder_t::intern_calc_route_elevated(const koord3d start, const koor
 	gu = welt->lookup(start + koordup);
 	if( gu && is_allowed_step(gu,gu,&dummy, true) ) {
 		// DBG_MESSAGE("way_builder_t::intern_calc_route()","cannot start on (%i,%i,%i)",start.x,start.y,start.z);
-		tmp = &(route_t::nodes[step]);
-		step ++;
+		tmp = search_context->get_node();
 		tmp->parent = NULL;
 		tmp->gr = gu;
 		tmp->f = calc_distance(start, ziel, ziel);
@@ -1908,9 +2145,6 @@ sint32 way_builder_t::intern_calc_route_elevated(const koord3d start, const koor
 
 	INT_CHECK("wegbauer 347");
 
-	// get exclusively the tile list
-	route_t::GET_NODE();
-
 	// to speed up search, but may not find all shortest ways
 	uint32 min_dist = 99999999;
 
@@ -2096,16 +2330,19 @@ DBG_DEBUG("insert to close","(%i,%i,%i)  f=%i",gr->get_pos().x,gr->get_pos().y,g
 
 			const uint32 new_f = new_g+new_dist;
 
-			if((step&0x03)==0) {
+			if((search_context->get_used_nodes()&0x03)==0) {
 				INT_CHECK( "wegbauer 1347" );
 #ifdef DEBUG_ROUTES
-				if((step&1023)==0) {minimap_t::get_instance()->calc_map();}
+				if((search_context->get_used_nodes()&1023)==0) {minimap_t::get_instance()->calc_map();}
 #endif
 			}
 
 			// not in there or taken out => add new
-			route_t::ANode *k=&(route_t::nodes[step]);
-			step++;
+			route_t::ANode *k = search_context->get_node();
+			if(  k==NULL  ) {
+				pool_exhausted = true;
+				break;
+			}
 
 			k->parent = tmp;
 			k->gr = to;
@@ -2121,19 +2358,17 @@ DBG_DEBUG("insert to close","(%i,%i,%i)  f=%i",gr->get_pos().x,gr->get_pos().y,g
 DBG_DEBUG("insert to open","(%i,%i,%i)  f=%i",to->get_pos().x,to->get_pos().y,to->get_pos().z,k->f);
 #endif
 		}
-	} while (!queue.empty() && step < route_t::MAX_STEP);
+	} while (!queue.empty() && !pool_exhausted);
 
 #ifdef DEBUG_ROUTES
-DBG_DEBUG("way_builder_t::intern_calc_route()","steps=%i  (max %i) in route, open %i, cost %u",step,route_t::MAX_STEP,queue.get_count(),tmp->g);
+DBG_DEBUG("way_builder_t::intern_calc_route()","steps=%i  (max %i) in route, open %i, cost %u",search_context->get_used_nodes(),search_context->get_max_nodes(),queue.get_count(),tmp->g);
 #endif
 	INT_CHECK("wegbauer 194");
 
-	route_t::RELEASE_NODE();
-
 	// target reached?
-	if(  !(ziel == gr_pos)  ||  step>=route_t::MAX_STEP  ||  tmp->parent==NULL  ||  tmp->g > maximum  ) {
-		if (step>=route_t::MAX_STEP) {
-			dbg->warning("way_builder_t::intern_calc_route()","Too many steps (%i>=max %i) in route (too long/complex)",step,route_t::MAX_STEP);
+	if(  !(ziel == gr_pos)  ||  pool_exhausted  ||  tmp->parent==NULL  ||  tmp->g > maximum  ) {
+		if (pool_exhausted) {
+			dbg->warning("way_builder_t::intern_calc_route()","Too many steps (%i>=max %i) in route (too long/complex)",search_context->get_used_nodes(),search_context->get_max_nodes());
 		}
 		return -1;
 	}
@@ -2303,7 +2538,12 @@ uint32 ms = dr_time();
 			}
 		}
 		else {
-			cost2 = intern_calc_route( start, ziel );
+			if(  bidirectional  &&  (bautyp & terraform_flag) == 0  ) {
+				cost2 = intern_calc_route_bidirectional( start, ziel );
+			}
+			else {
+				cost2 = intern_calc_route( start, ziel );
+			}
 			INT_CHECK("wegbauer 1165");
 			if(cost2 < 0) {
 				intern_calc_route( ziel, start );
@@ -9,6 +9,9 @@
 
 #include "../simtypes.h"
 #include "../dataobj/koord3d.h"
+#include "../dataobj/marker.h"
+#include "../dataobj/route.h"
+#include "../tpl/binary_heap_tpl.h"
 #include "../tpl/vector_tpl.h"
 
 
@@ -21,6 +24,57 @@ class grund_t;
 class tool_selector_t;
 
 
+/**
+ * Memory for the route search of the way builder: node pool, open lists
+ * and closed tiles. Unlike route_t::nodes it is not shared with the vehicle
+ * routing, so way builders with different contexts can search at the same time.
+ * The pool grows in blocks up to the maximum number of steps, so the memory
+ * follows the longest search done so far.
+ */
+class way_search_context_t
+{
+	/// nodes are never moved, since they point to their parents
+	vector_tpl<route_t::ANode *> blocks;
+	uint32 max_nodes;
+	uint32 used_nodes;
+
+	/// per side of a bidirectional search: open addressing table of the closed nodes by tile
+	route_t::ANode **closed[2];
+	uint32 closed_size[2];
+	uint32 closed_count[2];
+
+	static uint32 hash(const grund_t *gr) { return (uint32)(((size_t)gr >> 4) * 2654435761u); }
+
+public:
+	way_search_context_t();
+	~way_search_context_t();
+
+	/**
+	 * Clears all lists for a new search on a map of the given size.
+	 * At most @p steps nodes are handed out.
+	 */
+	void init(uint32 steps, sint16 size_x, sint16 size_y);
+
+	/// @returns an unused node or NULL if the pool is exhausted
+	route_t::ANode *get_node();
+
+	uint32 get_used_nodes() const { return used_nodes; }
+	uint32 get_max_nodes() const { return max_nodes; }
+
+	/// open lists, the second one is only used by the backward half of a bidirectional search
+	binary_heap_tpl<route_t::ANode *> queue[2];
+
+	/// closed tiles: forward/backward for a bidirectional search, below/above for elevated ways
+	marker_t marker[2];
+
+	/// remembers @p node as the closed node of its tile for @p side (each tile at most once)
+	void add_closed(int side, route_t::ANode *node);
+
+	/// @returns the node closed on @p gr by @p side, or NULL
+	route_t::ANode *get_closed(int side, const grund_t *gr) const;
+};
+
+
 /**
  * way building class with its own route finding
  */
@@ -83,9 +137,11 @@ private:
 		build_straight      = 1 << 0, ///< next step has to be straight
 		terraform           = 1 << 1, ///< terraform this tile
 		build_tunnel_bridge = 1 << 2, ///< bridge/tunnel ends here
-		is_upperlayer       = 1 << 3  ///< only used when elevated  true:upperlayer
+		is_upperlayer       = 1 << 3, ///< only used when elevated  true:upperlayer
+		backward_node       = 1 << 4  ///< only used when bidirectional: node of the search from the target
 	};
 
+
 	struct next_gr_t
 	{
 		next_gr_t() {}
@@ -134,6 +190,14 @@ private:
 	// has a warning message, why the route may have failed (could be wrong!)
 	const char *warn_fail;
 
+	/// used by all way builders which were not given their own context
+	static way_search_context_t main_search_context;
+
+	way_search_context_t *search_context;
+
+	/// search from both ends (see intern_calc_route_bidirectional)
+	bool bidirectional;
+
 public:
 	/**
 	 * This is the core routine for the way search
@@ -150,7 +214,31 @@ private:
 	// may modify next_gr array!
 	void check_for_bridge(const grund_t* parent_from, const grund_t* from, const vector_tpl<koord3d> &ziel);
 
+	/// puts the valid tiles of @p start with @p flags into the open list @p queue
+	bool init_route_search(const vector_tpl<koord3d> &start, binary_heap_tpl<route_t::ANode *> &queue, const koord3d &mini, const koord3d &maxi, uint8 flags);
+
+	/**
+	 * Adds all tiles reachable from @p tmp (including new bridges and tunnels)
+	 * to @p queue, heading towards the cuboid @p mini, @p maxi.
+	 * @returns false if the node pool is exhausted
+	 */
+	bool expand_route_node(route_t::ANode *tmp, binary_heap_tpl<route_t::ANode *> &queue, const marker_t &marker, const vector_tpl<koord3d> &ziel, const koord3d &mini, const koord3d &maxi, uint32 &min_dist, bool allow_terraform);
+
+	/**
+	 * Cost for the curves on the tile of @p node, which must have a parent, when going on to @p to.
+	 * Includes the malus for leaving an existing way. @p dir gets the direction from the parent to @p to.
+	 */
+	uint32 calc_curve_cost(const route_t::ANode *node, const grund_t *to, uint8 &dir) const;
+
 	sint32 intern_calc_route(const vector_tpl<koord3d> &start, const vector_tpl<koord3d> &ziel);
+
+	/**
+	 * Searches from both ends at once and joins both halves where they meet.
+	 * Explores far fewer tiles on long routes than intern_calc_route,
+	 * but the result is not always the cheapest route.
+	 * @returns the cost or -1 if no route was found
+	 */
+	sint32 intern_calc_route_bidirectional(const vector_tpl<koord3d> &start, const vector_tpl<koord3d> &ziel);
 	void intern_calc_straight_route(const koord3d start, const koord3d ziel);
 
 	sint32 intern_calc_route_elevated(const koord3d start, const koord3d ziel);
@@ -186,6 +274,8 @@ public:
 
 	uint32 get_count() const { return route.get_count(); }
 
+	const way_desc_t *get_desc() const { return desc; }
+
 	void set_prefer_parallel(bool yesno) {
 		prefer_parallel = yesno;
 	}
@@ -213,6 +303,18 @@ public:
 
 	void set_maximum(uint32 n) { maximum = n; }
 
+	/**
+	 * Search long routes from both ends (for AI roads).
+	 * The half from the target cannot terraform, so builders with terraform_flag always search forward.
+	 */
+	void set_bidirectional(bool yesno) { bidirectional = yesno; }
+
+	/**
+	 * Use an own search memory instead of the one shared by all way builders,
+	 * needed when searching outside the main thread. NULL resets to the shared one.
+	 */
+	void set_search_context(way_search_context_t *context) { search_context = context ? context : &main_search_context; }
+
 	way_builder_t(player_t *player);
 
 	const char *calc_straight_route(const koord3d start, const koord3d ziel);
@@ -18,6 +18,7 @@
 #include "../simdebug.h"
 #include "../utils/plainstring.h"
 #include "../utils/simstring.h"
+#include "../utils/perf_timer.h"
 #include "../display/rgba.h"
 
 #include "loadsave.h"
@@ -29,6 +30,7 @@
 #include "../io/rdwr/zstd_file_rdwr_stream.h"
 #endif
 #include "../io/rdwr/compare_file_rd_stream.h"
+#include "../io/rdwr/memory_rdwr_stream.h"
 
 #define INVALID_RDWR_ID (-1)
 
@@ -578,15 +580,19 @@ size_t loadsave_t::write(const void *buf, size_t len)
 			buff[curr_buff].buf[buff[curr_buff].pos++] = ((const char*)buf)[i++];
 		}
 
+		{
+			// the time the game waits for the stream
+			PERF_SCOPE(PERF_SAVEGAME_IO);
 #ifdef MULTI_THREAD
-		saving_trigger_flush();
+			saving_trigger_flush();
 
-		// switch buffers
-		curr_buff = (curr_buff+1)&1;
+			// switch buffers
+			curr_buff = (curr_buff+1)&1;
 #else
-		// not threaded, flush single buffer ourselves
-		flush_buffer(curr_buff);
+			// not threaded, flush single buffer ourselves
+			flush_buffer(curr_buff);
 #endif
+		}
 		// copy the rest
 		while(  i<len  ) {
 			buff[curr_buff].buf[buff[curr_buff].pos++] = ((const char*)buf)[i++];
@@ -651,15 +657,19 @@ size_t loadsave_t::read(void *buf, size_t len)
 				((char*)buf)[i++] = buff[curr_buff].buf[buff[curr_buff].pos++];
 			}
 		}
+		{
+			// the time the game waits for the stream
+			PERF_SCOPE(PERF_SAVEGAME_IO);
 #ifdef MULTI_THREAD
-		loading_trigger_fill_buffer();
+			loading_trigger_fill_buffer();
 
-		// switch buffers
-		curr_buff = (curr_buff+1)&1;
+			// switch buffers
+			curr_buff = (curr_buff+1)&1;
 #else
-		// not threaded, read more into single buffer ourselves
-		fill_buffer(curr_buff);
+			// not threaded, read more into single buffer ourselves
+			fill_buffer(curr_buff);
 #endif
+		}
 		// check if enough read
 		if(  len-i>buff[curr_buff].len  ) {
 			dbg->fatal("loadsave_t::read","savegame corrupt, not enough data");
@@ -1378,6 +1388,56 @@ stream_loadsave_t::stream_loadsave_t(rdwr_stream_t *stream)
 }
 
 
+block_loadsave_t::block_loadsave_t(loadsave_t *parent_) :
+	parent(parent_)
+{
+	assert(!parent->is_xml());
+
+	finfo = parent->finfo;
+	filename = parent->filename;
+
+	if(  parent->is_saving()  ) {
+		mem = new memory_rdwr_stream_t();
+	}
+	else {
+		uint32 len = 0;
+		parent->rdwr_long(len);
+		char *data = new char[len];
+		// in pieces, since the buffered read can only supply up to two buffers at a time
+		for(  uint32 done = 0;  done < len;  ) {
+			const size_t piece = min( len - done, (uint32)LS_BUF_SIZE );
+			if(  parent->read( data + done, piece ) != piece  ) {
+				delete [] data;
+				parent->fatal( "block_loadsave_t::block_loadsave_t()", "Savegame file mangled (block too short)!" );
+			}
+			done += piece;
+		}
+		mem = new memory_rdwr_stream_t(data, len);
+	}
+	stream = mem;
+}
+
+
+block_loadsave_t::~block_loadsave_t()
+{
+	if(  is_saving()  ) {
+		uint32 len = mem->get_size();
+		parent->rdwr_long(len);
+		for(  uint32 done = 0;  done < len;  ) {
+			const size_t piece = min( len - done, (uint32)LS_BUF_SIZE );
+			parent->write( mem->get_data() + done, piece );
+			done += piece;
+		}
+	}
+}
+
+
+bool block_loadsave_t::is_consumed() const
+{
+	return mem->get_remaining() == 0;
+}
+
+
 compare_loadsave_t::compare_loadsave_t(loadsave_t *file1, loadsave_t *file2)
 {
 	stream = new compare_file_rd_stream_t(file1->stream, file2->stream);
@@ -17,6 +17,7 @@
 
 class plainstring;
 class rgb888_t;
+class memory_rdwr_stream_t;
 
 
 /**
@@ -100,8 +101,6 @@ protected:
 
 	void flush_buffer(int buf_num);
 
-	bool is_xml() const { return mode&xml; }
-
 public:
 	static mode_t save_mode;     ///< default to use for saving
 	static mode_t autosave_mode; ///< default to use for autosaves and network mode client temp saves
@@ -142,6 +141,7 @@ public:
 	void set_buffered(bool enable);
 	unsigned get_buf_pos(int buf_num) const { return buff[buf_num].pos; }
 	bool is_loading() const { return stream && !stream->is_writing(); }
+	bool is_xml() const { return mode&xml; }
 	bool is_saving() const { return stream && stream->is_writing(); }
 	const char *get_pak_extension() const { return finfo.pak_extension; }
 
@@ -200,6 +200,7 @@ public:
 	}
 
 	friend class compare_loadsave_t; // to access stream
+	friend class block_loadsave_t;   // to access the parent file
 };
 
 
@@ -222,6 +223,29 @@ public:
 	~compare_loadsave_t();
 };
 
+/**
+ * An independent, length prefixed part of a save file, e.g. one region of the map.
+ * When saving, everything written to the block is collected in memory
+ * and appended to the parent file when the block is destroyed.
+ * When loading, the constructor reads the whole block from the parent file,
+ * so a block can be deserialised without touching the parent any more.
+ * Not possible in XML files.
+ */
+class block_loadsave_t : public loadsave_t
+{
+private:
+	loadsave_t *parent;
+	memory_rdwr_stream_t *mem; ///< same as stream
+
+public:
+	block_loadsave_t(loadsave_t *parent);
+	~block_loadsave_t();
+
+	/// @returns true, if all the data of a loaded block was read
+	bool is_consumed() const;
+};
+
+
 // this produces semi-automatic hierarchies
 class xml_tag_t
 {
@@ -13,7 +13,8 @@ class grund_t;
 
 /**
  * Class to mark tiles as visited during route search.
- * Singleton.
+ * Route searches share the two global instances, searches with
+ * their own memory (like the way builder) may create own markers.
  */
 class marker_t {
 	// added bit mask, because it allows a more efficient
@@ -35,7 +36,12 @@ class marker_t {
 	/// hashtable to mark non-ground tiles (bridges, tunnels)
 	ptrhashtable_tpl <const grund_t *, bool> more;
 
-	marker_t() : bits(NULL) { init(0, 0); }
+	/// the instance
+	static marker_t the_instance;
+	static marker_t second_instance;
+
+public:
+	marker_t() : bits(NULL), bits_length(0) { init(0, 0); }
 	~marker_t();
 
 	/**
@@ -45,10 +51,6 @@ class marker_t {
 	 */
 	void init(int world_size_x, int world_size_y);
 
-	/// the instance
-	static marker_t the_instance;
-	static marker_t second_instance;
-public:
 	/**
 	 * Return handle to marker instance.
 	 * @param world_size_x x-size of map
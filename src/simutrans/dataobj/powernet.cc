@@ -3,6 +3,8 @@
  * (see LICENSE.txt)
  */
 
+#include <assert.h>
+
 #include "../simdebug.h"
 #include "powernet.h"
 
@@ -19,15 +21,24 @@ const uint64 powernet_t::max_capacity = (uint64)4000000 << POWER_TO_MW; // (4 TW
 const uint8 powernet_t::FRACTION_PRECISION = 16;
 
 
-slist_tpl<powernet_t *> powernet_t::powernet_list;
+vector_tpl<powernet_t *> powernet_t::powernet_list;
+vector_tpl<powernet_t *> powernet_t::merged_list;
 
 
 void powernet_t::new_world()
 {
-	while(!powernet_list.empty()) {
-		powernet_t *net = powernet_list.remove_first();
+	// the powerlines are gone already, so just free everything
+	for(powernet_t* const net : merged_list) {
+		net->parent = NULL;
+		net->list_index = 0xFFFFFFFFu;
+		delete net;
+	}
+	merged_list.clear();
+	for(powernet_t* const net : powernet_list) {
+		net->list_index = 0xFFFFFFFFu;
 		delete net;
 	}
+	powernet_list.clear();
 }
 
 
@@ -44,11 +55,16 @@ powernet_t::powernet_t()
 #ifdef MULTI_THREAD
 	pthread_mutex_lock( &netlist_mutex );
 #endif
-	powernet_list.insert( this );
+	list_index = powernet_list.get_count();
+	powernet_list.append( this );
 #ifdef MULTI_THREAD
 	pthread_mutex_unlock( &netlist_mutex );
 #endif
 
+	parent = NULL;
+	size = 0;
+	refs = 0;
+
 	power_supply = 0;
 	power_demand = 0;
 
@@ -59,13 +75,90 @@ powernet_t::powernet_t()
 
 powernet_t::~powernet_t()
 {
+	if(  list_index != 0xFFFFFFFFu  ) {
+#ifdef MULTI_THREAD
+		pthread_mutex_lock( &netlist_mutex );
+#endif
+		list_remove( parent ? merged_list : powernet_list, this );
+#ifdef MULTI_THREAD
+		pthread_mutex_unlock( &netlist_mutex );
+#endif
+	}
+	if(  parent  ) {
+		parent->release();
+	}
+}
+
+
+void powernet_t::list_remove(vector_tpl<powernet_t *> &list, powernet_t *net)
+{
+	assert( list[net->list_index] == net );
+	powernet_t *last = list.pop_back();
+	if(  last != net  ) {
+		list[net->list_index] = last;
+		last->list_index = net->list_index;
+	}
+}
+
+
+void powernet_t::release()
+{
+	assert( refs > 0 );
+	if(  --refs == 0  ) {
+		delete this;
+	}
+}
+
+
+powernet_t *powernet_t::find()
+{
+	powernet_t *net = this;
+	while(  net->parent  ) {
+		powernet_t *const p = net->parent;
+		if(  p->parent  ) {
+			// skip one step, then p may not be needed any more
+			net->parent = p->parent;
+			net->parent->refs++;
+			p->release();
+		}
+		net = net->parent;
+	}
+	return net;
+}
+
+
+powernet_t *powernet_t::merge(powernet_t *a, powernet_t *b)
+{
+	a = a->find();
+	b = b->find();
+	if(  a == b  ) {
+		return a;
+	}
+	if(  a->size < b->size  ) {
+		powernet_t *const tmp = a;
+		a = b;
+		b = tmp;
+	}
+
+	// b becomes part of a
+	b->parent = a;
+	a->refs++;
+	a->size += b->size;
+	a->power_supply += b->power_supply;
+	a->power_demand += b->power_demand;
+	b->power_supply = 0;
+	b->power_demand = 0;
+
 #ifdef MULTI_THREAD
 	pthread_mutex_lock( &netlist_mutex );
 #endif
-	powernet_list.remove( this );
+	list_remove( powernet_list, b );
+	b->list_index = merged_list.get_count();
+	merged_list.append( b );
 #ifdef MULTI_THREAD
 	pthread_mutex_unlock( &netlist_mutex );
 #endif
+	return a;
 }
 
 /**
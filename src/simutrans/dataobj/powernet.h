@@ -8,7 +8,7 @@
 
 
 #include "../simtypes.h"
-#include "../tpl/slist_tpl.h"
+#include "../tpl/vector_tpl.h"
 
 
 /** @file powernet.h Data structure to manage a net of powerlines - a powernet */
@@ -17,6 +17,10 @@
 /**
  * Data class for power networks. A two phase queue to store
  * and hand out power.
+ *
+ * Connecting two networks just links the smaller one to the larger one (union-find),
+ * so the powerlines of the smaller one need not be changed. Powerlines must always
+ * use the root of their net, see get_root().
  */
 class powernet_t
 {
@@ -39,7 +43,31 @@ public:
 	static void step_all(uint32 delta_t);
 
 private:
-	static slist_tpl<powernet_t *> powernet_list;
+	/// the roots, which are stepped
+	static vector_tpl<powernet_t *> powernet_list;
+
+	/// nets merged into another one, kept while something still points to them
+	static vector_tpl<powernet_t *> merged_list;
+
+	/// the net this one was merged into, NULL for roots
+	powernet_t *parent;
+
+	/// powerlines in this net (for roots), the smaller net is merged into the larger one
+	uint32 size;
+
+	/// powerlines and merged nets pointing to this one
+	uint32 refs;
+
+	/// position in powernet_list or merged_list
+	uint32 list_index;
+
+	static void list_remove(vector_tpl<powernet_t *> &list, powernet_t *net);
+
+	/// like get_root(), but shortens the path on the way
+	powernet_t *find();
+
+	/// deletes this net, when nothing points to it any more
+	void release();
 
 	// Network power supply.
 	uint64 power_supply;
@@ -60,6 +88,31 @@ public:
 
 	uint64 get_max_capacity() const { return max_capacity; }
 
+	/**
+	 * @returns the net holding the power of this one (itself, if it was not merged)
+	 * Changes nothing, so it can be called from several threads.
+	 */
+	powernet_t *get_root()
+	{
+		powernet_t *net = this;
+		while(  net->parent  ) {
+			net = net->parent;
+		}
+		return net;
+	}
+
+	/**
+	 * Merges the nets of @p a and @p b, including their supply and demand.
+	 * @returns the root of the merged net
+	 */
+	static powernet_t *merge(powernet_t *a, powernet_t *b);
+
+	/// a powerline uses this net now
+	void attach() { refs++; get_root()->size++; }
+
+	/// a powerline does not use this net any more; deletes the net, when nothing uses it
+	void detach() { get_root()->size--; release(); }
+
 	/**
 	 * Add power supply for next step.
 	 */
@@ -19,6 +19,7 @@
 #include "environment.h"
 
 #include"../utils/simrandom.h"
+#include "../utils/perf_timer.h"
 
 // define USE_VALGRIND_MEMCHECK to make
 // valgrind aware of the memory pool for A* nodes
@@ -687,7 +688,11 @@ route_t::route_result_t route_t::calc_route(karte_t *welt, const koord3d ziel, c
 #ifdef DEBUG_ROUTES
 	const uint32 ms = dr_time();
 #endif
-	bool ok = intern_calc_route(welt, start, ziel, tdriver, max_khm, 0xFFFFFFFFul );
+	bool ok;
+	{
+		PERF_SCOPE(PERF_CALC_ROUTE);
+		ok = intern_calc_route(welt, start, ziel, tdriver, max_khm, 0xFFFFFFFFul );
+	}
 #ifdef DEBUG_ROUTES
 	if(tdriver->get_waytype()==water_wt) {
 		DBG_DEBUG("route_t::calc_route()", "route from %d,%d to %d,%d with %i steps in %u ms found.", start.x, start.y, ziel.x, ziel.y, route.get_count()-1, dr_time()-ms );
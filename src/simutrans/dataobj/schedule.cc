@@ -96,6 +96,33 @@ halthandle_t schedule_t::get_next_halt( player_t *player, halthandle_t halt ) co
 }
 
 
+const minivec_tpl<halthandle_t> &schedule_t::get_halts(const player_t *player) const
+{
+	const uint8 count = entries.get_count();
+	const uint32 version = haltestelle_t::get_layout_version();
+	if(  halts_version != version  ||  halts_owner != player  ||  halts.get_count() != count  ) {
+		halts.clear();
+		halts_pos.clear();
+		for(schedule_entry_t const& i : entries) {
+			halts.append( haltestelle_t::get_halt( i.pos, player ), count );
+			halts_pos.append( i.pos, count );
+		}
+		halts_owner = player;
+		halts_version = version;
+	}
+	else {
+		// entries may have been changed in place
+		for(  uint8 i=0;  i<count;  i++  ) {
+			if(  halts_pos[i] != entries[i].pos  ) {
+				halts[i] = haltestelle_t::get_halt( entries[i].pos, player );
+				halts_pos[i] = entries[i].pos;
+			}
+		}
+	}
+	return halts;
+}
+
+
 /* returns a valid halthandle if there is a previous halt in the schedule;
  * it may however not be allowed to load there, if the owner mismatches!
  */
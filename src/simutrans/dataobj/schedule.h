@@ -30,6 +30,12 @@ class schedule_t
 
 	static schedule_entry_t dummy_entry;
 
+	/// cache for get_halts(), with the positions they were resolved for
+	mutable minivec_tpl<halthandle_t> halts;
+	mutable minivec_tpl<koord3d> halts_pos;
+	mutable const player_t *halts_owner;
+	mutable uint32 halts_version;
+
 	/**
 	 * Fix up current_stop value, which we may have made out of range
 	 */
@@ -44,7 +50,7 @@ class schedule_t
 	}
 
 protected:
-	schedule_t() : editing_finished(false), current_stop(0) {}
+	schedule_t() : editing_finished(false), current_stop(0), halts_owner(NULL), halts_version(0) {}
 
 public:
 	enum schedule_type {
@@ -132,6 +138,13 @@ public:
 
 	virtual ~schedule_t() {}
 
+	/**
+	 * The halt of each entry for @p player, unbound for waypoints and depots.
+	 * Entries are only resolved again after they or the halts changed
+	 * (see haltestelle_t::get_layout_version()). Not thread safe.
+	 */
+	const minivec_tpl<halthandle_t> &get_halts(const player_t *player) const;
+
 	/**
 	 * returns a halthandle for the next halt in the schedule (or unbound)
 	 */
@@ -0,0 +1,104 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include <stdlib.h>
+
+#include "step_arena.h"
+#include "../simdebug.h"
+
+
+// memory is requested from the system in blocks of this size (or larger for large allocations)
+#define ARENA_BLOCK_SIZE (64*1024)
+
+// all allocations are aligned to this
+#define ARENA_ALIGN (16)
+
+
+step_arena_t::step_arena_t() :
+	current_block(0),
+	used(0),
+	last(NULL),
+	live(0),
+	allocations(0),
+	last_step_allocations(0),
+	bytes(0),
+	last_step_bytes(0)
+{
+}
+
+
+step_arena_t::~step_arena_t()
+{
+	for(block_t const& b : blocks) {
+		free( b.mem );
+	}
+}
+
+
+step_arena_t &step_arena_t::get_instance()
+{
+	static step_arena_t arena;
+	return arena;
+}
+
+
+void *step_arena_t::allocate(size_t size)
+{
+	size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+	if(  current_block >= blocks.get_count()  ||  used + size > blocks[current_block].size  ) {
+		// next block, if it is large enough, else a new one
+		if(  current_block < blocks.get_count()  ) {
+			current_block++;
+		}
+		if(  current_block >= blocks.get_count()  ||  blocks[current_block].size < size  ) {
+			block_t b;
+			b.size = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+			b.mem = (char *)malloc( b.size );
+			if(  b.mem == NULL  ) {
+				dbg->fatal( "step_arena_t::allocate()", "Could not allocate %zu bytes", b.size );
+			}
+			blocks.insert_at( current_block, b );
+		}
+		used = 0;
+	}
+
+	last = blocks[current_block].mem + used;
+	used += size;
+	live++;
+	allocations++;
+	bytes += size;
+	return last;
+}
+
+
+void step_arena_t::deallocate(void *p, size_t)
+{
+	if(  p == last  ) {
+		// can be reused right away
+		used = (char *)p - blocks[current_block].mem;
+		last = NULL;
+	}
+	if(  live > 0  ) {
+		live--;
+	}
+}
+
+
+void step_arena_t::end_step()
+{
+	if(  live > 0  ) {
+		// rewinding would hand out their memory again
+		dbg->fatal( "step_arena_t::end_step()", "%u allocations still in use", live );
+	}
+	current_block = 0;
+	used = 0;
+	last = NULL;
+
+	last_step_allocations = allocations;
+	last_step_bytes = bytes;
+	allocations = 0;
+	bytes = 0;
+}
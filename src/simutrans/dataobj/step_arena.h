@@ -0,0 +1,72 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef DATAOBJ_STEP_ARENA_H
+#define DATAOBJ_STEP_ARENA_H
+
+
+#include "../simtypes.h"
+#include "../tpl/vector_tpl.h"
+
+
+/**
+ * Memory for scratch data of the simulation, which is only needed during one step.
+ * Allocating just moves a pointer; all memory is given back at once at the end of karte_t::step().
+ * Not in between, since sync_step() runs inside step() by INT_CHECK, when scratch data is still in use.
+ * Only for the main thread. Nothing allocated here may outlive the function that allocated it.
+ */
+class step_arena_t : public vector_allocator_t
+{
+private:
+	struct block_t
+	{
+		char *mem;
+		size_t size;
+	};
+
+	vector_tpl<block_t> blocks;
+	uint32 current_block;
+	size_t used; ///< in the current block
+
+	/// the most recent allocation can be given back, i.e. when a vector grows
+	void *last;
+
+	/// allocations not yet deallocated
+	uint32 live;
+
+	uint32 allocations, last_step_allocations;
+	size_t bytes, last_step_bytes;
+
+	step_arena_t();
+
+public:
+	~step_arena_t();
+
+	/// the arena of the world
+	static step_arena_t &get_instance();
+
+	void *allocate(size_t size) OVERRIDE;
+	void deallocate(void *p, size_t size) OVERRIDE;
+
+	/// frees all memory and starts counting for the next step; nothing may be in use anymore
+	void end_step();
+
+	/// statistics of the last complete step including its sync steps
+	uint32 get_last_step_allocations() const { return last_step_allocations; }
+	size_t get_last_step_bytes() const { return last_step_bytes; }
+};
+
+
+/**
+ * A vector_tpl for scratch lists of the simulation, see step_arena_t.
+ */
+template<class T>
+class step_vector_tpl : public vector_tpl<T>
+{
+public:
+	explicit step_vector_tpl(uint32 cap = 0) : vector_tpl<T>( cap, &step_arena_t::get_instance() ) {}
+};
+
+#endif
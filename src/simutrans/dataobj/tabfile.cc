@@ -6,6 +6,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <algorithm>
 
 #ifdef MAKEOBJ
 #include "../descriptor/writer/obj_writer.h"
@@ -89,6 +90,22 @@ void tabfileobj_t::clear()
 }
 
 
+std::string tabfileobj_t::get_sorted_lines() const
+{
+	vector_tpl<std::string> lines(objinfo.get_count());
+	for(auto const& i : objinfo) {
+		lines.append( std::string(i.key) + "=" + i.value.str + "\n" );
+	}
+	std::sort( lines.begin(), lines.end() );
+
+	std::string result;
+	for(std::string const& line : lines) {
+		result += line;
+	}
+	return result;
+}
+
+
 // private helps to get x y value pairs needed for koord etc.
 template<class I>
 bool tabfileobj_t::get_x_y( const char *key, I &x, I &y )
@@ -7,6 +7,7 @@
 #define DATAOBJ_TABFILE_H
 
 #include <stdio.h>
+#include <string>
 
 #include "../tpl/stringhashtable_tpl.h"
 #include "../tpl/vector_tpl.h"
@@ -138,6 +139,12 @@ public:
 	 */
 	void clear();
 
+	/**
+	 * @returns all pairs as "key=value" lines in sorted order,
+	 * so equal objects give equal strings regardless of the order of their lines
+	 */
+	std::string get_sorted_lines() const;
+
 	/**
 	 * Get the value for a key - key must be lowercase
 	 *
@@ -16,11 +16,7 @@
 #include "../../utils/simstring.h"
 #include "../../simdebug.h"
 #include "../../io/raw_image.h"
-
-#ifndef _WIN32
-#include <dirent.h>
-#include <sys/types.h>
-#endif
+#include "source_image_cache.h"
 
 
 struct dimension
@@ -32,17 +28,21 @@ struct dimension
 };
 
 
-std::string image_writer_t::last_img_file;
-
-raw_image_t image_writer_t::input_img;
+const raw_image_t *image_writer_t::input_img = NULL;
 int image_writer_t::img_size = 64;
 
 
+int image_writer_t::get_pixel_bits()
+{
+	return 16;
+}
+
+
 uint32 image_writer_t::block_getpix(int x, int y)
 {
-	const uint8 *pixel_data = input_img.access_pixel(x, y);
+	const uint8 *pixel_data = input_img->access_pixel(x, y);
 
-	switch (input_img.get_format()) {
+	switch (input_img->get_format()) {
 		case raw_image_t::FMT_GRAY8: {
 			const uint8 gray_level = pixel_data[0];
 			return
@@ -76,6 +76,47 @@ uint32 image_writer_t::block_getpix(int x, int y)
 #define ALPHA_THRESHOLD (0xF8000000u)
 
 
+// image_t::rgbtab is looked up for every pixel, so it is hashed
+#define SPECIAL_HASH_SIZE (128)
+static sint8 special_hash[SPECIAL_HASH_SIZE];
+static bool special_hash_init = false;
+
+
+static inline uint32 special_hash_pos(uint32 rgb)
+{
+	return ((rgb * 0x9E3779B1u) >> 25) & (SPECIAL_HASH_SIZE-1);
+}
+
+
+/// @returns the index of rgb in image_t::rgbtab or -1
+static int find_special_color(uint32 rgb)
+{
+	if(  !special_hash_init  ) {
+		for(  int i = 0;  i < SPECIAL_HASH_SIZE;  i++  ) {
+			special_hash[i] = -1;
+		}
+		for(  int i = 0;  i < SPECIAL;  i++  ) {
+			uint32 pos = special_hash_pos(image_t::rgbtab[i]);
+			while(  special_hash[pos] >= 0  &&  image_t::rgbtab[(int)special_hash[pos]] != image_t::rgbtab[i]  ) {
+				pos = (pos + 1) & (SPECIAL_HASH_SIZE-1);
+			}
+			// for duplicates the first index wins, like in a linear search
+			if(  special_hash[pos] < 0  ) {
+				special_hash[pos] = i;
+			}
+		}
+		special_hash_init = true;
+	}
+
+	for(  uint32 pos = special_hash_pos(rgb);  special_hash[pos] >= 0;  pos = (pos + 1) & (SPECIAL_HASH_SIZE-1)  ) {
+		if(  image_t::rgbtab[(int)special_hash[pos]] == rgb  ) {
+			return special_hash[pos];
+		}
+	}
+	return -1;
+}
+
+
 /**
  * Encodes image data into the internal representation,
  * considers special colors.
@@ -92,12 +133,11 @@ static uint16 pixrgb_to_pixval(uint32 rgb)
 		// alpha is now between 0 ... 30
 
 		// first see if this is a transparent special color (like player color)
-		for (int i = 0; i < SPECIAL; i++) {
-			if (image_t::rgbtab[i] == (uint32)(rgb & 0x00FFFFFFu)) {
-				// player or light color
-				pix = 0x8020 +  i*31 + alpha;
-				return endian(pix);
-			}
+		const int i = find_special_color(rgb & 0x00FFFFFFu);
+		if (i >= 0) {
+			// player or light color
+			pix = 0x8020 +  i*31 + alpha;
+			return endian(pix);
 		}
 		// else store color as 3 red, 4, green, 3 red
 		pix = ((rgb >> 14) & 0x0380) | ((rgb >>  9) & 0x0078) | ((rgb >> 5) & 0x07);
@@ -107,11 +147,10 @@ static uint16 pixrgb_to_pixval(uint32 rgb)
 
 
 	// non-transparent pixel
-	for (int i = 0; i < SPECIAL; i++) {
-		if (image_t::rgbtab[i] == (uint32)rgb) {
-			pix = 0x8000 + i;
-			return pix;
-		}
+	const int i = find_special_color(rgb);
+	if (i >= 0) {
+		pix = 0x8000 + i;
+		return pix;
 	}
 
 	const int r = (rgb >> 16);
@@ -259,82 +298,23 @@ uint16 *image_writer_t::encode_image(int x, int y, dimension* dim, int* len)
 
 bool image_writer_t::block_load(const char *fname)
 {
-	// The last image file is cached
+	// Decoded files are cached, see source_image_cache_t.
 	// Note that this method accepts any file name if the content has a supported format,
 	// even though makeobj only supports image file names with a ".png" suffix.
 	// See image_writer_t::write_obj for details.
-	if(  last_img_file == fname  ) {
-		return true;
-	}
-	else if (load_image_from_file(fname)) {
-		if ((input_img.get_width()%img_size != 0) || (input_img.get_height()%img_size != 0)) {
+	input_img = source_image_cache_t::get(fname);
+	if (input_img) {
+		if ((input_img->get_width()%img_size != 0) || (input_img->get_height()%img_size != 0)) {
 			dbg->error("image_writer_t::block_load", "Cannot load image file '%s': "
 				"Size not divisible by %d.", fname, img_size);
-			last_img_file = "";
+			input_img = NULL;
 			return false;
 		}
 
-		last_img_file = fname;
 		return true;
 	}
 
 	// error message is handled by image_writer_t::write_obj
-	last_img_file = "";
-	return false;
-}
-
-
-bool image_writer_t::load_image_from_file(const char* fname)
-{
-	if (input_img.read_from_file(fname)) {
-		return true;
-	}
-
-	// Not an exact match, try to case-insensitive search.
-#ifndef _WIN32
-	std::string actual_path;
-	size_t len = strlen(fname);
-	actual_path.reserve(len);
-	const char * sep_beg = fname;
-	const char * sep_end = sep_beg + strspn(sep_beg, "/");
-	if (sep_end == sep_beg) {
-		// relative
-		actual_path = "./";
-	}
-
-	char const * end = fname + len;
-
-	std::string name;
-	while (true) {
-		actual_path.insert(actual_path.end(), sep_beg, sep_end);
-		sep_beg = sep_end + strcspn(sep_end, "/");
-		if (sep_beg == sep_end) {
-			break;
-		}
-		name.assign(sep_end, sep_beg);
-		DIR * dir = opendir(actual_path.c_str());
-		if (!dir) {
-			break;
-		}
-		struct dirent * ent = NULL;
-		while ((ent = readdir(dir)) != NULL) {
-			if (!STRICMP(ent->d_name, name.c_str())) {
-				actual_path += ent->d_name;
-				break;
-			}
-		}
-		closedir(dir);
-		if (!ent) {
-			break;
-		}
-
-		if (sep_beg == end) {
-			return input_img.read_from_file(actual_path.c_str());
-		}
-		sep_end = sep_beg + strspn(sep_beg, "/");
-	}
-#endif
-
 	return false;
 }
 
@@ -413,10 +393,10 @@ void image_writer_t::write_obj(FILE* outfp, obj_node_t& parent, std::string an_i
 		}
 
 		if (col == -1) {
-			col = row % (input_img.get_width()  / img_size);
-			row = row / (input_img.get_height() / img_size);
+			col = row % (input_img->get_width()  / img_size);
+			row = row / (input_img->get_height() / img_size);
 		}
-		if (col >= (int)(input_img.get_width() / img_size) || row >= (int)(input_img.get_height() / img_size)) {
+		if (col >= (int)(input_img->get_width() / img_size) || row >= (int)(input_img->get_height() / img_size)) {
 			char reason[1024];
 			sprintf(reason, "invalid image number in %s.%s", imagekey.c_str(), numkey.c_str());
 			throw obj_pak_exception_t("image_writer_t", reason);
@@ -16,11 +16,7 @@
 #include "../../utils/simstring.h"
 #include "../../simdebug.h"
 #include "../../io/raw_image.h"
-
-#ifndef _WIN32
-#include <dirent.h>
-#include <sys/types.h>
-#endif
+#include "source_image_cache.h"
 
 
 struct dimension
@@ -32,18 +28,22 @@ struct dimension
 };
 
 
-std::string image_writer_t::last_img_file;
-
-raw_image_t image_writer_t::input_img;
+const raw_image_t *image_writer_t::input_img = NULL;
 int image_writer_t::img_size = 64;
 
 
+int image_writer_t::get_pixel_bits()
+{
+	return 32;
+}
+
+
 uint32 image_writer_t::block_getpix(int x, int y)
 {
-	const uint8 * pixel_data = input_img.access_pixel(x, y);
+	const uint8 * pixel_data = input_img->access_pixel(x, y);
     uint32 pix;
     
-	switch (input_img.get_format()) {
+	switch (input_img->get_format()) {
 		case raw_image_t::FMT_GRAY8: {
 			const uint8 gray_level = pixel_data[0];
 			pix =
@@ -154,82 +154,23 @@ uint32 *image_writer_t::encode_image(int x, int y, dimension * dim, int * len)
 
 bool image_writer_t::block_load(const char *fname)
 {
-	// The last image file is cached
+	// Decoded files are cached, see source_image_cache_t.
 	// Note that this method accepts any file name if the content has a supported format,
 	// even though makeobj only supports image file names with a ".png" suffix.
 	// See image_writer_t::write_obj for details.
-	if(  last_img_file == fname  ) {
-		return true;
-	}
-	else if (load_image_from_file(fname)) {
-		if ((input_img.get_width()%img_size != 0) || (input_img.get_height()%img_size != 0)) {
+	input_img = source_image_cache_t::get(fname);
+	if (input_img) {
+		if ((input_img->get_width()%img_size != 0) || (input_img->get_height()%img_size != 0)) {
 			dbg->error("image_writer_t::block_load", "Cannot load image file '%s': "
 				"Size not divisible by %d.", fname, img_size);
-			last_img_file = "";
+			input_img = NULL;
 			return false;
 		}
 
-		last_img_file = fname;
 		return true;
 	}
 
 	// error message is handled by image_writer_t::write_obj
-	last_img_file = "";
-	return false;
-}
-
-
-bool image_writer_t::load_image_from_file(const char* fname)
-{
-	if (input_img.read_from_file(fname)) {
-		return true;
-	}
-
-	// Not an exact match, try to case-insensitive search.
-#ifndef _WIN32
-	std::string actual_path;
-	size_t len = strlen(fname);
-	actual_path.reserve(len);
-	const char * sep_beg = fname;
-	const char * sep_end = sep_beg + strspn(sep_beg, "/");
-	if (sep_end == sep_beg) {
-		// relative
-		actual_path = "./";
-	}
-
-	char const * end = fname + len;
-
-	std::string name;
-	while (true) {
-		actual_path.insert(actual_path.end(), sep_beg, sep_end);
-		sep_beg = sep_end + strcspn(sep_end, "/");
-		if (sep_beg == sep_end) {
-			break;
-		}
-		name.assign(sep_end, sep_beg);
-		DIR * dir = opendir(actual_path.c_str());
-		if (!dir) {
-			break;
-		}
-		struct dirent * ent = NULL;
-		while ((ent = readdir(dir)) != NULL) {
-			if (!STRICMP(ent->d_name, name.c_str())) {
-				actual_path += ent->d_name;
-				break;
-			}
-		}
-		closedir(dir);
-		if (!ent) {
-			break;
-		}
-
-		if (sep_beg == end) {
-			return input_img.read_from_file(actual_path.c_str());
-		}
-		sep_end = sep_beg + strspn(sep_beg, "/");
-	}
-#endif
-
 	return false;
 }
 
@@ -308,10 +249,10 @@ void image_writer_t::write_obj(FILE* outfp, obj_node_t& parent, std::string an_i
 		}
 
 		if (col == -1) {
-			col = row % (input_img.get_width()  / img_size);
-			row = row / (input_img.get_height() / img_size);
+			col = row % (input_img->get_width()  / img_size);
+			row = row / (input_img->get_height() / img_size);
 		}
-		if (col >= (int)(input_img.get_width() / img_size) || row >= (int)(input_img.get_height() / img_size)) {
+		if (col >= (int)(input_img->get_width() / img_size) || row >= (int)(input_img->get_height() / img_size)) {
 			char reason[1024];
 			sprintf(reason, "invalid image number in %s.%s", imagekey.c_str(), numkey.c_str());
 			throw obj_pak_exception_t("image_writer_t", reason);
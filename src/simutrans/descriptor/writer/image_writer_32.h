@@ -23,8 +23,8 @@ class image_writer_t : public obj_writer_t
 private:
 	static image_writer_t the_instance;
 
-	static std::string last_img_file;
-	static raw_image_t input_img;
+	/// the image file currently read from, see block_load()
+	static const raw_image_t *input_img;
 	static int img_size; // default 64
 
 	image_writer_t() { register_writer(false); }
@@ -36,6 +36,9 @@ public:
 
 	static void set_img_size(int _img_size) { img_size = _img_size; }
 
+	/// size of the written pixels, differs between the image writers linked into makeobj
+	static int get_pixel_bits();
+
 	obj_type get_type() const OVERRIDE { return obj_image; }
 	const char* get_type_name() const OVERRIDE { return "image"; }
 
@@ -44,10 +47,6 @@ public:
 private:
 	bool block_load(const char* fname);
 
-	/// Loads @ref input_img with the contents of @p fname, ignores case of @p filename.
-	/// @returns true on success
-	bool load_image_from_file(const char *fname);
-
 	/// Encodes an image into a sprite data structure, considers
 	/// special colors.
 	static uint32 *encode_image(int x, int y, dimension* dim, int* len);
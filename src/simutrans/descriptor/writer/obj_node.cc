@@ -92,6 +92,15 @@ void obj_node_t::write(FILE* fp)
 }
 
 
+uint32 obj_node_t::add_copied_child(uint32 size)
+{
+	const uint32 offset = free_offset;
+	free_offset += size;
+	desc.nchildren++;
+	return offset;
+}
+
+
 void obj_node_t::write_data(FILE* fp, const void* data)
 {
 	write_data_at(fp, data, 0, desc.size);
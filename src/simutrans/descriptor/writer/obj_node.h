@@ -29,6 +29,9 @@ public:
 	// ONLY CALL BEFORE ANY NODES ARE CREATED !!!
 	static void set_start_offset(uint32 offset) { free_offset = offset; }
 
+	// offset in file where the next node will be put
+	static uint32 get_free_offset() { return free_offset; }
+
 	// reads a node into a given obj_node_info_t
 	static bool read_node(FILE* fp, obj_node_info_t &node );
 
@@ -60,6 +63,11 @@ public:
 		this->write_uint32(fp, (sint32) data, offset);
 	}
 
+	// Reserve space for a complete child node including its own children,
+	// which the caller copies there from an earlier pak file
+	// Returns the offset in file of the reserved space
+	uint32 add_copied_child(uint32 size);
+
 	// Write the internal node info to the file
 	// DO THIS AFTER ALL CHILD NODES ARE WRITTEN !!!
 	void write(FILE* fp);
@@ -58,6 +58,7 @@ public:
 	static void write(FILE* fp, obj_node_t& parent, tabfileobj_t& obj);
 
 	static void set_img_size(int img_size) { obj_writer_t::default_image_size = img_size; }
+	static int get_img_size() { return obj_writer_t::default_image_size; }
 };
 
 
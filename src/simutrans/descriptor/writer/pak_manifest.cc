@@ -0,0 +1,191 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pak_manifest.h"
+#include "../../utils/sha1.h"
+
+
+static void hash_to_hex(const sha1_hash_t &hash, char *hex)
+{
+	for(  int i = 0;  i < 20;  i++  ) {
+		sprintf( hex + 2*i, "%02x", hash[i] );
+	}
+}
+
+
+static bool hex_to_hash(const char *hex, sha1_hash_t &hash)
+{
+	if(  strlen(hex) != 40  ) {
+		return false;
+	}
+	for(  int i = 0;  i < 20;  i++  ) {
+		unsigned int byte;
+		if(  sscanf( hex + 2*i, "%2x", &byte ) != 1  ) {
+			return false;
+		}
+		hash[i] = (uint8)byte;
+	}
+	return true;
+}
+
+
+sha1_hash_t pak_manifest_t::hash_block(const std::string &block)
+{
+	sha1_hash_t hash;
+	SHA1 sha1;
+	sha1.Input( block.c_str(), block.size() );
+	sha1.Result( hash );
+	return hash;
+}
+
+
+bool pak_manifest_t::get_file_hash(const std::string &fname, sha1_hash_t &hash)
+{
+	for(file_t const& f : hashed_files) {
+		if(  f.name == fname  ) {
+			hash = f.hash;
+			return !hash.empty();
+		}
+	}
+
+	file_t f;
+	f.name = fname;
+	if(  FILE *file = fopen( fname.c_str(), "rb" )  ) {
+		SHA1 sha1;
+		char buf[65536];
+		size_t len;
+		while(  (len = fread( buf, 1, sizeof(buf), file )) > 0  ) {
+			sha1.Input( buf, len );
+		}
+		fclose( file );
+		sha1.Result( f.hash );
+	}
+	// unreadable files are remembered with an empty hash
+	hashed_files.append( f );
+	hash = f.hash;
+	return !hash.empty();
+}
+
+
+bool pak_manifest_t::load(const std::string &fname, const std::string &header)
+{
+	clear();
+
+	FILE *file = fopen( fname.c_str(), "r" );
+	if(  !file  ) {
+		return false;
+	}
+
+	char line[4096];
+	bool ok = fgets( line, sizeof(line), file )  &&  header + "\n" == line;
+	while(  ok  &&  fgets( line, sizeof(line), file )  ) {
+		line[strcspn( line, "\r\n" )] = 0;
+
+		// "obj <hash> <offset> <size> <target>" followed by "file <hash> <name>" lines
+		char hex[41];
+		unsigned int offset, size;
+		int name_start = 0;
+		if(  sscanf( line, "obj %40s %u %u %n", hex, &offset, &size, &name_start ) == 3  &&  name_start > 0  ) {
+			entry_t *entry = new entry_t;
+			ok = hex_to_hash( hex, entry->obj_hash );
+			entry->target = line + name_start;
+			entry->offset = offset;
+			entry->size = size;
+			entries.append( entry );
+		}
+		else if(  sscanf( line, "file %40s %n", hex, &name_start ) == 1  &&  name_start > 0  &&  !entries.empty()  ) {
+			file_t f;
+			ok = hex_to_hash( hex, f.hash );
+			f.name = line + name_start;
+			entries.back()->files.append( f );
+		}
+		else {
+			ok = false;
+		}
+	}
+	fclose( file );
+
+	if(  !ok  ) {
+		// written by another makeobj or damaged
+		clear();
+	}
+	return ok;
+}
+
+
+bool pak_manifest_t::save(const std::string &fname, const std::string &header) const
+{
+	FILE *file = fopen( fname.c_str(), "w" );
+	if(  !file  ) {
+		return false;
+	}
+
+	fprintf( file, "%s\n", header.c_str() );
+	char hex[41];
+	for(entry_t const* entry : entries) {
+		hash_to_hex( entry->obj_hash, hex );
+		fprintf( file, "obj %s %u %u %s\n", hex, entry->offset, entry->size, entry->target.c_str() );
+		for(file_t const& f : entry->files) {
+			hash_to_hex( f.hash, hex );
+			fprintf( file, "file %s %s\n", hex, f.name.c_str() );
+		}
+	}
+	return fclose( file ) == 0;
+}
+
+
+const pak_manifest_t::entry_t *pak_manifest_t::find(const sha1_hash_t &obj_hash)
+{
+	for(entry_t const* entry : entries) {
+		if(  entry->obj_hash != obj_hash  ) {
+			continue;
+		}
+		bool unchanged = true;
+		for(file_t const& f : entry->files) {
+			sha1_hash_t hash;
+			if(  !get_file_hash( f.name, hash )  ||  hash != f.hash  ) {
+				unchanged = false;
+				break;
+			}
+		}
+		if(  unchanged  ) {
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+
+void pak_manifest_t::add(entry_t *entry)
+{
+	if(  !entry->target.empty()  ) {
+		for(entry_t *&e : entries) {
+			if(  e->target == entry->target  ) {
+				delete e;
+				e = entry;
+				return;
+			}
+		}
+	}
+	entries.append( entry );
+}
+
+
+void pak_manifest_t::hash_files(entry_t &entry)
+{
+	for(file_t &f : entry.files) {
+		get_file_hash( f.name, f.hash );
+	}
+}
+
+
+void pak_manifest_t::clear()
+{
+	clear_ptr_vector( entries );
+	hashed_files.clear();
+}
@@ -0,0 +1,86 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef DESCRIPTOR_WRITER_PAK_MANIFEST_H
+#define DESCRIPTOR_WRITER_PAK_MANIFEST_H
+
+
+#include <string>
+
+#include "../../tpl/vector_tpl.h"
+#include "../../utils/sha1_hash.h"
+
+
+/**
+ * Remembers from which inputs the objects of a pak file were compiled,
+ * so an incremental makeobj run can reuse the nodes of unchanged objects.
+ * An object is unchanged, if the hash of its .dat block and the hashes
+ * of all image files it read are the same as last time.
+ */
+class pak_manifest_t
+{
+public:
+	struct file_t
+	{
+		std::string name;
+		sha1_hash_t hash;
+	};
+
+	struct entry_t
+	{
+		sha1_hash_t obj_hash;
+		/// file name when writing individual files, else empty
+		std::string target;
+		/// where the nodes of this object are in the pak file; offset is 0 for individual files
+		uint32 offset, size;
+		/// the image files read while compiling this object
+		vector_tpl<file_t> files;
+	};
+
+private:
+	vector_tpl<entry_t *> entries;
+
+	/// files hashed during this run, so every file is read only once
+	vector_tpl<file_t> hashed_files;
+
+public:
+	~pak_manifest_t() { clear(); }
+
+	/// @returns the hash of the contents of @p block
+	static sha1_hash_t hash_block(const std::string &block);
+
+	/**
+	 * Reads a manifest written by save() with the same @p header.
+	 * @returns false if there is none, then the manifest is empty
+	 */
+	bool load(const std::string &fname, const std::string &header);
+
+	bool save(const std::string &fname, const std::string &header) const;
+
+	/**
+	 * @returns the entry of an object with this hash, whose image files are all unchanged,
+	 * or NULL if it must be compiled
+	 */
+	const entry_t *find(const sha1_hash_t &obj_hash);
+
+	/**
+	 * Takes over an entry allocated with new.
+	 * When writing individual files it replaces the entry with the same target.
+	 */
+	void add(entry_t *entry);
+
+	/// sets the hashes of the files in @p entry from the current contents of the files
+	void hash_files(entry_t &entry);
+
+	void clear();
+
+	bool empty() const { return entries.empty(); }
+
+private:
+	/// @returns false if the file cannot be read
+	bool get_file_hash(const std::string &fname, sha1_hash_t &hash);
+};
+
+#endif
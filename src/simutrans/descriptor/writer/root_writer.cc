@@ -11,10 +11,17 @@
 #include "obj_node.h"
 #include "obj_writer.h"
 #include "root_writer.h"
+#include "image_writer.h"
+#include "pak_manifest.h"
+#include "source_image_cache.h"
 
 using std::string;
 
 string root_writer_t::inpath;
+bool root_writer_t::incremental = false;
+
+// number of following .dat files whose images are decoded in advance
+#define DAT_PREFETCH (4)
 
 void root_writer_t::write_header(FILE* fp)
 {
@@ -30,6 +37,37 @@ void root_writer_t::write_header(FILE* fp)
 }
 
 
+static uint32 get_file_size(const char *fname)
+{
+	uint32 size = 0;
+	if(  FILE *fp = fopen(fname, "rb")  ) {
+		fseek(fp, 0, SEEK_END);
+		size = ftell(fp);
+		fclose(fp);
+	}
+	return size;
+}
+
+
+// copies compiled nodes from the last pak file into the new one
+static bool copy_bytes(FILE* outfp, uint32 to, FILE* infp, uint32 from, uint32 size)
+{
+	if (fseek(infp, from, SEEK_SET) != 0  ||  fseek(outfp, to, SEEK_SET) != 0) {
+		return false;
+	}
+	char buf[65536];
+	while (size > 0) {
+		const size_t len = size < sizeof(buf) ? size : sizeof(buf);
+		if (fread(buf, len, 1, infp) != 1) {
+			return false;
+		}
+		fwrite(buf, len, 1, outfp);
+		size -= len;
+	}
+	return true;
+}
+
+
 // makes pak file(s)
 void root_writer_t::write(const char* filename, int argc, char* argv[])
 {
@@ -39,12 +77,38 @@ void root_writer_t::write(const char* filename, int argc, char* argv[])
 	bool separate = false;
 	string file = find.complete(filename, "pak");
 
+	// with incremental builds, the nodes of unchanged objects are taken from the last pak file
+	pak_manifest_t manifest;
+	pak_manifest_t new_manifest; // for a single pak file, the old one is only read
+	string manifest_name;
+	FILE* oldfp = NULL;
+	char manifest_header[128];
+	sprintf(manifest_header, "Simutrans makeobj manifest %u pak%d %dbit", COMPILER_VERSION_CODE, get_img_size(), image_writer_t::get_pixel_bits());
+
 	if (file[file.size()-1] == '/') {
 		printf("writing individual files to %s\n", filename);
 		separate = true;
+
+		if (incremental) {
+			manifest_name = file.substr(0, file.size()-1) + ".manifest";
+			manifest.load(manifest_name, manifest_header);
+		}
 	}
 	else {
-		outfp = fopen(file.c_str(), "wb");
+		string outname = file;
+		if (incremental) {
+			// the last pak file is read while the new one is written
+			manifest_name = file + ".manifest";
+			oldfp = fopen(file.c_str(), "rb");
+			if (oldfp) {
+				char header[sizeof(manifest_header) + 16]; // space and file size
+				snprintf(header, sizeof(header), "%s %u", manifest_header, get_file_size(file.c_str()));
+				manifest.load(manifest_name, header);
+			}
+			outname = file + ".tmp";
+		}
+
+		outfp = fopen(outname.c_str(), "wb");
 
 		if (!outfp) {
 			dbg->fatal( "Write pak", "Cannot create destination file %s", filename );
@@ -61,10 +125,30 @@ void root_writer_t::write(const char* filename, int argc, char* argv[])
 	for(  int i=0;  i==0  ||  i<argc;  i++  ) {
 		const char* arg = (i < argc) ? argv[i] : "./";
 
+		inpath = arg;
+		string::size_type n = inpath.rfind('/');
+
+		if(n!=string::npos) {
+			inpath = inpath.substr(0, n + 1);
+		}
+		else {
+			inpath = "";
+		}
+
 		find.search(arg, "dat");
+		searchfolder_t::const_iterator next = find.begin();
 		for(const char* const& i : find) {
 			tabfile_t infile;
 
+			// decode the images of the following files while this one is written
+			// (not if they will probably be reused)
+			while(  next != find.end()  &&  next <= &i + DAT_PREFETCH  ) {
+				if (manifest.empty()) {
+					source_image_cache_t::prefetch_dat(*next, inpath);
+				}
+				++next;
+			}
+
 			if (infile.open(i)) {
 				tabfileobj_t obj;
 
@@ -72,22 +156,37 @@ void root_writer_t::write(const char* filename, int argc, char* argv[])
 					printf("   Reading file %s\n", i);
 				}
 
-				inpath = arg;
-				string::size_type n = inpath.rfind('/');
-
-				if(n!=string::npos) {
-					inpath = inpath.substr(0, n + 1);
-				}
-				else {
-					inpath = "";
-				}
-
 				while(infile.read(obj)) {
-					if(separate) {
-						string name(filename);
+					string name;
+					sha1_hash_t obj_hash;
 
+					if(separate) {
+						name = filename;
 						name = name + obj.get("obj") + "." + obj.get("name") + ".pak";
+					}
+
+					if (incremental) {
+						obj_hash = pak_manifest_t::hash_block(obj.get_sorted_lines());
+
+						if (const pak_manifest_t::entry_t* old = manifest.find(obj_hash)) {
+							if (separate) {
+								if (old->target == name  &&  get_file_size(name.c_str()) == old->size) {
+									if (debuglevel >= log_t::LEVEL_WARN) {
+										printf("   Unchanged file %s\n", name.c_str());
+									}
+									continue;
+								}
+							}
+							else if (oldfp  &&  copy_bytes(outfp, obj_node_t::get_free_offset(), oldfp, old->offset, old->size)) {
+								pak_manifest_t::entry_t* entry = new pak_manifest_t::entry_t(*old);
+								entry->offset = node->add_copied_child(old->size);
+								new_manifest.add(entry);
+								continue;
+							}
+						}
+					}
 
+					if(separate) {
 						outfp = fopen(name.c_str(), "wb");
 						if (!outfp) {
 							dbg->fatal( "Write pak", "Cannot create destination file %s", filename );
@@ -100,6 +199,14 @@ void root_writer_t::write(const char* filename, int argc, char* argv[])
 						write_header(outfp);
 						node = new obj_node_t(this, 0, NULL);
 					}
+
+					// remember the image files this object is made of
+					const uint32 start = separate ? 0 : obj_node_t::get_free_offset();
+					vector_tpl<string> used_files;
+					if (incremental) {
+						source_image_cache_t::set_used_files(&used_files);
+					}
+
 					obj_writer_t::write(outfp, *node, obj);
 					obj.unused( "#;-/" );
 
@@ -108,6 +215,23 @@ void root_writer_t::write(const char* filename, int argc, char* argv[])
 						delete node;
 						fclose(outfp);
 					}
+
+					if (incremental) {
+						source_image_cache_t::set_used_files(NULL);
+
+						pak_manifest_t::entry_t* entry = new pak_manifest_t::entry_t;
+						entry->obj_hash = obj_hash;
+						entry->target = name;
+						entry->offset = start;
+						entry->size = obj_node_t::get_free_offset() - start;
+						for(string const& f : used_files) {
+							pak_manifest_t::file_t used;
+							used.name = f;
+							entry->files.append(used);
+						}
+						manifest.hash_files(*entry);
+						(separate ? manifest : new_manifest).add(entry);
+					}
 				}
 			}
 			else {
@@ -115,10 +239,29 @@ void root_writer_t::write(const char* filename, int argc, char* argv[])
 			}
 		}
 	}
+	source_image_cache_t::clear();
+
 	if (!separate) {
 		node->write(outfp);
 		delete node;
 		fclose(outfp);
+
+		if (incremental) {
+			if (oldfp) {
+				fclose(oldfp);
+			}
+			remove(file.c_str());
+			if (rename((file + ".tmp").c_str(), file.c_str()) != 0) {
+				dbg->fatal( "Write pak", "Cannot rename %s.tmp to %s", file.c_str(), file.c_str() );
+			}
+
+			char header[sizeof(manifest_header) + 16]; // space and file size
+			snprintf(header, sizeof(header), "%s %u", manifest_header, get_file_size(file.c_str()));
+			new_manifest.save(manifest_name, header);
+		}
+	}
+	else if (incremental) {
+		manifest.save(manifest_name, manifest_header);
 	}
 }
 
@@ -23,6 +23,7 @@ private:
 	static root_writer_t the_instance;
 
 	static std::string inpath;
+	static bool incremental;
 
 	root_writer_t() { register_writer(false); }
 
@@ -61,6 +62,9 @@ public:
 
 	static const std::string & get_inpath() { return inpath; }
 
+	/// reuse unchanged objects of the last run, see pak_manifest_t
+	static void set_incremental(bool on) { incremental = on; }
+
 private:
 	bool do_copy(FILE* outfp, obj_node_info_t& root, const char* open_file_name);
 	bool do_dump(const char* open_file_name);
@@ -0,0 +1,350 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+#include "source_image_cache.h"
+#include "../../io/raw_image.h"
+#include "../../utils/simstring.h"
+
+#ifdef MULTI_THREAD
+#include "../../utils/simthread.h"
+#endif
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/types.h>
+#endif
+
+
+// number of decoded files kept
+#define IMAGE_CACHE_SIZE (16)
+
+// threads decoding prefetched files
+#define IMAGE_CACHE_THREADS (4)
+
+
+struct cached_image_t
+{
+	enum state_t { QUEUED, DECODING, READY };
+
+	std::string fname;
+	raw_image_t *img; // NULL if the file could not be read
+	state_t state;
+	uint32 last_used;
+};
+
+
+// only changed by the main thread
+static vector_tpl<cached_image_t *> cache;
+static uint32 use_counter = 0;
+static vector_tpl<std::string> *used_files = NULL;
+
+#ifdef MULTI_THREAD
+// protects the queue and the state and image of all entries
+static pthread_mutex_t cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+// signalled when the queue changed or a file is decoded
+static pthread_cond_t cache_cond = PTHREAD_COND_INITIALIZER;
+static vector_tpl<cached_image_t *> decode_queue;
+static pthread_t workers[IMAGE_CACHE_THREADS];
+static int worker_count = 0;
+static bool stop_workers = false;
+#endif
+
+
+/// Loads @p img with the contents of @p fname, ignores case of @p fname.
+/// @returns true on success
+static bool load_image_from_file(const char *fname, raw_image_t &img)
+{
+	if (img.read_from_file(fname)) {
+		return true;
+	}
+
+	// Not an exact match, try to case-insensitive search.
+#ifndef _WIN32
+	std::string actual_path;
+	size_t len = strlen(fname);
+	actual_path.reserve(len);
+	const char * sep_beg = fname;
+	const char * sep_end = sep_beg + strspn(sep_beg, "/");
+	if (sep_end == sep_beg) {
+		// relative
+		actual_path = "./";
+	}
+
+	char const * end = fname + len;
+
+	std::string name;
+	while (true) {
+		actual_path.insert(actual_path.end(), sep_beg, sep_end);
+		sep_beg = sep_end + strcspn(sep_end, "/");
+		if (sep_beg == sep_end) {
+			break;
+		}
+		name.assign(sep_end, sep_beg);
+		DIR * dir = opendir(actual_path.c_str());
+		if (!dir) {
+			break;
+		}
+		struct dirent * ent = NULL;
+		while ((ent = readdir(dir)) != NULL) {
+			if (!STRICMP(ent->d_name, name.c_str())) {
+				actual_path += ent->d_name;
+				break;
+			}
+		}
+		closedir(dir);
+		if (!ent) {
+			break;
+		}
+
+		if (sep_beg == end) {
+			return img.read_from_file(actual_path.c_str());
+		}
+		sep_end = sep_beg + strspn(sep_beg, "/");
+	}
+#endif
+
+	return false;
+}
+
+
+static cached_image_t *find_entry(const std::string &fname)
+{
+	for(cached_image_t *entry : cache) {
+		if(  entry->fname == fname  ) {
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+
+static void remove_entry(cached_image_t *entry)
+{
+	cache.remove(entry);
+	delete entry->img;
+	delete entry;
+}
+
+
+/**
+ * Frees decoded files until there is room for one more.
+ * Entries used or prefetched since the last get() are kept, if @p keep_current is set.
+ * @returns false if there is no room
+ */
+static bool make_room(bool keep_current)
+{
+	while(  cache.get_count() >= IMAGE_CACHE_SIZE  ) {
+		cached_image_t *oldest = NULL;
+#ifdef MULTI_THREAD
+		// the workers change the state, but leave ready entries alone
+		pthread_mutex_lock(&cache_mutex);
+#endif
+		for(cached_image_t *entry : cache) {
+			if(  entry->state == cached_image_t::READY  &&  (!keep_current  ||  entry->last_used != use_counter)  ) {
+				if(  oldest == NULL  ||  entry->last_used < oldest->last_used  ) {
+					oldest = entry;
+				}
+			}
+		}
+#ifdef MULTI_THREAD
+		pthread_mutex_unlock(&cache_mutex);
+#endif
+		if(  oldest == NULL  ) {
+			// all still decoding
+			return false;
+		}
+		remove_entry(oldest);
+	}
+	return true;
+}
+
+
+#ifdef MULTI_THREAD
+static void *decode_thread(void *)
+{
+	pthread_mutex_lock(&cache_mutex);
+	while(  true  ) {
+		while(  decode_queue.empty()  &&  !stop_workers  ) {
+			pthread_cond_wait(&cache_cond, &cache_mutex);
+		}
+		if(  stop_workers  ) {
+			break;
+		}
+
+		cached_image_t *entry = decode_queue[0];
+		decode_queue.remove_at(0);
+		entry->state = cached_image_t::DECODING;
+		pthread_mutex_unlock(&cache_mutex);
+
+		// only existing files are queued, so no case-insensitive search here
+		raw_image_t *img = new raw_image_t();
+		if(  !img->read_from_file(entry->fname.c_str())  ) {
+			delete img;
+			img = NULL;
+		}
+
+		pthread_mutex_lock(&cache_mutex);
+		entry->img = img;
+		entry->state = cached_image_t::READY;
+		pthread_cond_broadcast(&cache_cond);
+	}
+	pthread_mutex_unlock(&cache_mutex);
+	return NULL;
+}
+#endif
+
+
+void source_image_cache_t::prefetch(const std::string &fname)
+{
+#ifdef MULTI_THREAD
+	if(  find_entry(fname)  ||  !make_room(true)  ) {
+		return;
+	}
+
+	// queue only files that exist, anything else is left to get() and its error messages
+	FILE *file = fopen(fname.c_str(), "rb");
+	if(  !file  ) {
+		return;
+	}
+	fclose(file);
+
+	while(  worker_count < IMAGE_CACHE_THREADS  ) {
+		if(  pthread_create(&workers[worker_count], NULL, decode_thread, NULL) != 0  ) {
+			break;
+		}
+		worker_count++;
+	}
+	if(  worker_count == 0  ) {
+		return;
+	}
+
+	cached_image_t *entry = new cached_image_t;
+	entry->fname = fname;
+	entry->img = NULL;
+	entry->state = cached_image_t::QUEUED;
+	entry->last_used = use_counter;
+	cache.append(entry);
+
+	pthread_mutex_lock(&cache_mutex);
+	decode_queue.append(entry);
+	pthread_cond_signal(&cache_cond);
+	pthread_mutex_unlock(&cache_mutex);
+#else
+	(void)fname;
+#endif
+}
+
+
+void source_image_cache_t::prefetch_dat(const char *dat_fname, const std::string &inpath)
+{
+#ifdef MULTI_THREAD
+	FILE *file = fopen(dat_fname, "r");
+	if(  !file  ) {
+		return;
+	}
+
+	// image values are "[> ]path/file.row[.col[,x[,y]]]", anything with a dot is tried
+	char line[4096];
+	while(  fgets(line, sizeof(line), file)  ) {
+		const char *value = strchr(line, '=');
+		if(  line[0] == '#'  ||  value == NULL  ) {
+			continue;
+		}
+		std::string imagekey = trim(value + 1);
+		if(  !imagekey.empty()  &&  imagekey[0] == '>'  ) {
+			imagekey = trim(imagekey.substr(1));
+		}
+
+		const std::string::size_type slash = imagekey.rfind('/');
+		const std::string::size_type dot = imagekey.find('.', slash == std::string::npos ? 0 : slash + 1);
+		if(  dot == std::string::npos  ||  dot == 0  ) {
+			continue;
+		}
+		prefetch(inpath + imagekey.substr(0, dot) + ".png");
+	}
+	fclose(file);
+#else
+	(void)dat_fname;
+	(void)inpath;
+#endif
+}
+
+
+const raw_image_t *source_image_cache_t::get(const std::string &fname)
+{
+	use_counter++;
+	if(  used_files  ) {
+		used_files->append_unique( fname );
+	}
+
+	if(  cached_image_t *entry = find_entry(fname)  ) {
+#ifdef MULTI_THREAD
+		pthread_mutex_lock(&cache_mutex);
+		if(  entry->state == cached_image_t::QUEUED  ) {
+			// not started yet, faster to read it right here
+			decode_queue.remove(entry);
+			entry->state = cached_image_t::READY;
+		}
+		while(  entry->state != cached_image_t::READY  ) {
+			pthread_cond_wait(&cache_cond, &cache_mutex);
+		}
+		pthread_mutex_unlock(&cache_mutex);
+#endif
+		if(  entry->img  ) {
+			entry->last_used = use_counter;
+			return entry->img;
+		}
+		// prefetching failed, try again with case-insensitive search and error messages
+		remove_entry(entry);
+	}
+
+	raw_image_t *img = new raw_image_t();
+	if(  !load_image_from_file(fname.c_str(), *img)  ) {
+		delete img;
+		return NULL;
+	}
+
+	make_room(false);
+	cached_image_t *entry = new cached_image_t;
+	entry->fname = fname;
+	entry->img = img;
+	entry->state = cached_image_t::READY;
+	entry->last_used = use_counter;
+	cache.append(entry);
+	return img;
+}
+
+
+void source_image_cache_t::set_used_files(vector_tpl<std::string> *files)
+{
+	used_files = files;
+}
+
+
+void source_image_cache_t::clear()
+{
+#ifdef MULTI_THREAD
+	pthread_mutex_lock(&cache_mutex);
+	stop_workers = true;
+	pthread_cond_broadcast(&cache_cond);
+	pthread_mutex_unlock(&cache_mutex);
+
+	for(  int i = 0;  i < worker_count;  i++  ) {
+		pthread_join(workers[i], NULL);
+	}
+	worker_count = 0;
+	stop_workers = false;
+	decode_queue.clear();
+#endif
+
+	while(  !cache.empty()  ) {
+		remove_entry(cache.back());
+	}
+	use_counter = 0;
+}
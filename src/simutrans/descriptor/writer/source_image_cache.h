@@ -0,0 +1,55 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef DESCRIPTOR_WRITER_SOURCE_IMAGE_CACHE_H
+#define DESCRIPTOR_WRITER_SOURCE_IMAGE_CACHE_H
+
+
+#include <string>
+
+#include "../../tpl/vector_tpl.h"
+
+
+class raw_image_t;
+
+
+/**
+ * The decoded image files of makeobj. Sheets used by many objects are read only once,
+ * and the least recently used ones are dropped when the cache is full.
+ * With MULTI_THREAD, files requested by prefetch() are decoded by worker threads
+ * while the objects before them are written.
+ */
+class source_image_cache_t
+{
+public:
+	/**
+	 * Starts decoding this file in the background, if it exists and is not cached yet.
+	 * Does nothing if there is no room in the cache.
+	 */
+	static void prefetch(const std::string &fname);
+
+	/**
+	 * Scans a .dat file for values that look like image references and prefetches their files.
+	 * @param inpath the directory the image names are relative to
+	 */
+	static void prefetch_dat(const char *dat_fname, const std::string &inpath);
+
+	/**
+	 * @returns the decoded file or NULL if it cannot be read, ignores the case of @p fname.
+	 * The image stays valid until the next call of get() or clear().
+	 */
+	static const raw_image_t *get(const std::string &fname);
+
+	/**
+	 * Appends the name of every file requested by get() to @p files, each name once.
+	 * Stops with NULL.
+	 */
+	static void set_used_files(vector_tpl<std::string> *files);
+
+	/// Stops the workers and frees all images.
+	static void clear();
+};
+
+#endif
@@ -52,6 +52,21 @@ gl_texture_t * gl_texture_t::create_texture(int width, int height, uint8_t * dat
 }
 
 
+void gl_texture_t::destroy_texture(gl_texture_t * tex)
+{
+    if(tex == NULL) {
+        return;
+    }
+
+    if(gl_currently_bound_tex_id == tex->tex_id) {
+        gl_currently_bound_tex_id = 0;
+    }
+    GLuint texId = tex->tex_id;
+    glDeleteTextures(1, &texId);
+    delete tex;
+}
+
+
 void gl_texture_t::update_texture(uint8_t * data)
 {
     // dbg->message("update_texture()", "id=%d", tex_id);
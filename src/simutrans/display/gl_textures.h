@@ -20,6 +20,9 @@ public:
     }
 
     static gl_texture_t * create_texture(int width, int height, uint8_t * data);
+
+    // frees the texture object and deletes tex
+    static void destroy_texture(gl_texture_t * tex);
     static void bind(uint32_t tex_id);
 
     void update_texture(uint8_t * data);
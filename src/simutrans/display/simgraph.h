@@ -194,6 +194,21 @@ void display_vline_wh_clip_rgb(scr_coord_val xp, scr_coord_val yp, scr_coord_val
 
 void display_flush_framebuffer_to_buffer();
 
+/**
+ * The ground of the main view can be kept in a texture between frames. It is split into
+ * chunks, and only chunks marked dirty are drawn again, each with its own clipping:
+ * begin(); mark_dirty() ...; while(next_chunk(chunk)) { draw ground in chunk }; end();
+ * display_ground_cache_end() copies the cached ground into the frame.
+ * @param area the region the ground is drawn in; a different area discards the cache
+ * @param background the cache is cleared to this color
+ * @return false, if there is no cache; then the ground must be drawn directly
+ */
+bool display_ground_cache_begin(const scr_rect &area, rgba_t background);
+void display_ground_cache_invalidate();
+void display_ground_cache_mark_dirty(scr_coord_val x, scr_coord_val y, scr_coord_val w, scr_coord_val h);
+bool display_ground_cache_next_chunk(scr_rect &chunk);
+void display_ground_cache_end();
+
 void display_flush_buffer();
 
 void display_show_pointer(int yesno);
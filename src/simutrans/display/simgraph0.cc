@@ -244,6 +244,28 @@ void display_flush_buffer()
 {
 }
 
+bool display_ground_cache_begin(const scr_rect &, rgba_t)
+{
+	return false;
+}
+
+void display_ground_cache_invalidate()
+{
+}
+
+void display_ground_cache_mark_dirty(scr_coord_val, scr_coord_val, scr_coord_val, scr_coord_val)
+{
+}
+
+bool display_ground_cache_next_chunk(scr_rect &)
+{
+	return false;
+}
+
+void display_ground_cache_end()
+{
+}
+
 void display_show_pointer(int)
 {
 }
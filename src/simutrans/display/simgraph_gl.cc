@@ -42,6 +42,19 @@ static GLuint gl_texture_colorbuffer;
 static int gl_framebuffer_size;
 static bool framebuffer_active;
 
+
+// cache for the ground of the main view, see display_ground_cache_begin()
+#define GROUND_CACHE_CHUNK_SIZE (256)
+static GLuint ground_cache_fbo = 0;
+static gl_texture_t * ground_cache_texture = NULL;
+static scr_rect ground_cache_area;      // drawing coordinates covered by the cache
+static int ground_cache_chunks_x;
+static int ground_cache_chunks_y;
+static bool * ground_cache_dirty = NULL;
+static int ground_cache_next_chunk;     // next chunk to test in display_ground_cache_next_chunk()
+static rgba_t ground_cache_background;
+static bool ground_cache_drawing = false; // the scissor box must stay on the current chunk
+
 scr_coord_val tile_raster_width = 16;
 scr_coord_val base_tile_raster_width = 16;
 
@@ -794,6 +807,15 @@ void display_pop_clip_wh(CLIP_NUM_DEF0)
 }
 
 
+// while drawing a chunk of the ground cache, nothing must leak into the other chunks
+static void disable_scissor()
+{
+	if(!ground_cache_drawing) {
+		glDisable(GL_SCISSOR_TEST);
+	}
+}
+
+
 /**
  * Set color for subsequent drawing operations
  */
@@ -832,7 +854,7 @@ void display_tile_from_sheet(const gl_texture_t * gltex, int x, int y, int w, in
 
 	glEnd();
 
-    glDisable(GL_SCISSOR_TEST);
+    disable_scissor();
 }
 
 
@@ -1095,7 +1117,7 @@ void display_fillbox_wh(scr_coord_val x, scr_coord_val y, scr_coord_val w, scr_c
 
 	glEnd();
 
-	glDisable(GL_SCISSOR_TEST);
+	disable_scissor();
 }
 
 
@@ -1137,7 +1159,7 @@ void display_fillbox_wh_clip_rgb(scr_coord_val x, scr_coord_val y, scr_coord_val
 
 	glEnd();
 
-	glDisable(GL_SCISSOR_TEST);
+	disable_scissor();
 }
 
 
@@ -1256,6 +1278,177 @@ void display_flush_buffer()
 }
 
 
+static void ground_cache_free()
+{
+    gl_texture_t::destroy_texture(ground_cache_texture);
+    ground_cache_texture = NULL;
+    delete [] ground_cache_dirty;
+    ground_cache_dirty = NULL;
+    ground_cache_area = scr_rect();
+}
+
+
+bool display_ground_cache_begin(const scr_rect &area, rgba_t background)
+{
+    if(!framebuffer_active  ||  area.w <= 0  ||  area.h <= 0) {
+        return false;
+    }
+
+    if(ground_cache_texture == NULL  ||  area != ground_cache_area) {
+        ground_cache_free();
+
+        const int chunks_x = (area.w + GROUND_CACHE_CHUNK_SIZE - 1) / GROUND_CACHE_CHUNK_SIZE;
+        const int chunks_y = (area.h + GROUND_CACHE_CHUNK_SIZE - 1) / GROUND_CACHE_CHUNK_SIZE;
+        if(chunks_x * GROUND_CACHE_CHUNK_SIZE > gl_max_texture_size  ||  chunks_y * GROUND_CACHE_CHUNK_SIZE > gl_max_texture_size) {
+            return false;
+        }
+
+        if(ground_cache_fbo == 0) {
+            glGenFramebuffers(1, &ground_cache_fbo);
+        }
+        ground_cache_texture = gl_texture_t::create_texture(chunks_x * GROUND_CACHE_CHUNK_SIZE, chunks_y * GROUND_CACHE_CHUNK_SIZE, NULL);
+        // copied pixel by pixel, so no filtering
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, ground_cache_fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, ground_cache_texture->tex_id, 0);
+        const int status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        glBindFramebuffer(GL_FRAMEBUFFER, gl_fbo);
+
+        if(status != GL_FRAMEBUFFER_COMPLETE) {
+            dbg->warning("display_ground_cache_begin()", "Frame buffer status is not complete: %x, drawing the ground uncached", status);
+            ground_cache_free();
+            return false;
+        }
+
+        ground_cache_area = area;
+        ground_cache_chunks_x = chunks_x;
+        ground_cache_chunks_y = chunks_y;
+        ground_cache_dirty = new bool[chunks_x * chunks_y];
+        display_ground_cache_invalidate();
+    }
+
+    if(background != ground_cache_background) {
+        ground_cache_background = background;
+        display_ground_cache_invalidate();
+    }
+
+    ground_cache_next_chunk = 0;
+    return true;
+}
+
+
+void display_ground_cache_invalidate()
+{
+    for(int i = 0; i < ground_cache_chunks_x * ground_cache_chunks_y  &&  ground_cache_dirty; i++) {
+        ground_cache_dirty[i] = true;
+    }
+}
+
+
+void display_ground_cache_mark_dirty(scr_coord_val x, scr_coord_val y, scr_coord_val w, scr_coord_val h)
+{
+    if(ground_cache_dirty == NULL  ||  x + w <= ground_cache_area.x  ||  y + h <= ground_cache_area.y) {
+        return;
+    }
+
+    // to chunk coordinates, clipped to the cache
+    const int left = max(0, (x - ground_cache_area.x) / GROUND_CACHE_CHUNK_SIZE);
+    const int top = max(0, (y - ground_cache_area.y) / GROUND_CACHE_CHUNK_SIZE);
+    const int right = min(ground_cache_chunks_x - 1, (x + w - 1 - ground_cache_area.x) / GROUND_CACHE_CHUNK_SIZE);
+    const int bottom = min(ground_cache_chunks_y - 1, (y + h - 1 - ground_cache_area.y) / GROUND_CACHE_CHUNK_SIZE);
+
+    for(int cy = top; cy <= bottom; cy++) {
+        for(int cx = left; cx <= right; cx++) {
+            ground_cache_dirty[cy * ground_cache_chunks_x + cx] = true;
+        }
+    }
+}
+
+
+bool display_ground_cache_next_chunk(scr_rect &chunk)
+{
+    const int count = ground_cache_chunks_x * ground_cache_chunks_y;
+    while(ground_cache_next_chunk < count  &&  !ground_cache_dirty[ground_cache_next_chunk]) {
+        ground_cache_next_chunk++;
+    }
+    if(ground_cache_next_chunk >= count) {
+        return false;
+    }
+
+    if(!ground_cache_drawing) {
+        // the texture uses the same drawing coordinates as the map buffer, shifted to the cached area
+        glBindFramebuffer(GL_FRAMEBUFFER, ground_cache_fbo);
+        glMatrixMode(GL_PROJECTION);
+        glLoadIdentity();
+        glOrtho(ground_cache_area.x, ground_cache_area.x + ground_cache_texture->width,
+                ground_cache_area.y, ground_cache_area.y + ground_cache_texture->height, 1, -1);
+        glViewport(0, 0, ground_cache_texture->width, ground_cache_texture->height);
+        glEnable(GL_SCISSOR_TEST);
+        ground_cache_drawing = true;
+    }
+
+    const int cx = ground_cache_next_chunk % ground_cache_chunks_x;
+    const int cy = ground_cache_next_chunk / ground_cache_chunks_x;
+    ground_cache_dirty[ground_cache_next_chunk++] = false;
+
+    glScissor(cx * GROUND_CACHE_CHUNK_SIZE, cy * GROUND_CACHE_CHUNK_SIZE, GROUND_CACHE_CHUNK_SIZE, GROUND_CACHE_CHUNK_SIZE);
+
+    // an opaque background, so the chunks can be copied without blending
+    glClearColor(ground_cache_background.red, ground_cache_background.green, ground_cache_background.blue, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+    chunk = scr_rect(ground_cache_area.x + cx * GROUND_CACHE_CHUNK_SIZE, ground_cache_area.y + cy * GROUND_CACHE_CHUNK_SIZE,
+                     GROUND_CACHE_CHUNK_SIZE, GROUND_CACHE_CHUNK_SIZE);
+    return true;
+}
+
+
+void display_ground_cache_end()
+{
+    if(ground_cache_drawing) {
+        ground_cache_drawing = false;
+        glDisable(GL_SCISSOR_TEST);
+
+        // back to the map buffer
+        glBindFramebuffer(GL_FRAMEBUFFER, gl_fbo);
+        glMatrixMode(GL_PROJECTION);
+        glLoadIdentity();
+        glOrtho(0, gl_framebuffer_size, 0, gl_framebuffer_size, 1, -1);
+        glViewport(0, 0, gl_framebuffer_size, gl_framebuffer_size);
+        display_set_clip_wh(clip_rect.x, clip_rect.y, clip_rect.w, clip_rect.h);
+    }
+
+    const scr_rect &a = ground_cache_area;
+    const float w = a.w / (float)ground_cache_texture->width;
+    const float h = a.h / (float)ground_cache_texture->height;
+
+    gl_texture_t::bind(ground_cache_texture->tex_id);
+    glColor4f(1, 1, 1, 1);
+    glDisable(GL_BLEND);
+
+	glBegin(GL_QUADS);
+
+    glTexCoord2f(0, 0);
+	glVertex2i(a.x, a.y);
+
+    glTexCoord2f(w, 0);
+	glVertex2i(a.x + a.w, a.y);
+
+    glTexCoord2f(w, h);
+	glVertex2i(a.x + a.w, a.y + a.h);
+
+    glTexCoord2f(0, h);
+	glVertex2i(a.x, a.y + a.h);
+
+	glEnd();
+
+    glEnable(GL_BLEND);
+}
+
+
 void display_show_pointer(int v)
 {
 	dbg->message("display_show_pointer()", "%d", v);
@@ -1499,7 +1692,7 @@ void display_direct_line_rgb(const scr_coord_val x, const scr_coord_val y, const
 
 	glEnd();
 
-	glDisable(GL_SCISSOR_TEST);
+	disable_scissor();
     
 }
 
@@ -31,6 +31,19 @@ main_view_t::main_view_t(karte_t *welt)
 	outside_visible = true;
 	viewport = welt->get_viewport();
 	assert(welt  &&  viewport);
+	ground_cache_key = ground_cache_key_t();
+	last_cursor_pos = koord::invalid;
+}
+
+
+bool main_view_t::ground_cache_key_t::operator !=(const ground_cache_key_t &k) const
+{
+	return ij_off != k.ij_off  ||  x_off != k.x_off  ||  y_off != k.y_off  ||  raster_width != k.raster_width
+		||  underground_mode != k.underground_mode  ||  underground_level != k.underground_level
+		||  min_height != k.min_height  ||  max_height != k.max_height  ||  water_stage != k.water_stage
+		||  show_grid != k.show_grid  ||  show_owner != k.show_owner  ||  hide_under_cursor != k.hide_under_cursor
+		||  draw_earth_border != k.draw_earth_border  ||  draw_outside_tile != k.draw_outside_tile
+		||  day_night != k.day_night;
 }
 
 #if COLOUR_DEPTH != 0
@@ -117,6 +130,7 @@ void main_view_t::display(bool force_dirty)
 	welt->unset_dirty();
 	if(  force_dirty  ) {
 		mark_screen_dirty();
+		display_ground_cache_invalidate();
 		welt->set_background_dirty();
 		force_dirty = false;
 	}
@@ -295,9 +309,43 @@ void main_view_t::display_region( koord lt, koord wh, sint16 y_min, sint16 y_max
 	const koord cursor_pos = welt->get_zeiger() ? welt->get_zeiger()->get_pos().get_2d() : koord(-1000, -1000);
 	const bool needs_hiding = !env_t::hide_trees  ||  (env_t::hide_buildings != env_t::ALL_HIDDEN_BUILDING);
 
+	// the ground keeps being drawn from the first row, the objects only from the first row where something is visible
+	const sint16 ground_y_min = y_min;
+
+	// the ground is kept between frames, only the parts around changed tiles are drawn again
+	const scr_rect area( lt.x, lt.y, wh.x, wh.y );
+	const bool cached = display_ground_cache_begin( area, grund_t::underground_mode ? RGBA_BLACK : env_t::background_color_rgb );
+	if(  cached  ) {
+		ground_cache_key_t key;
+		key.ij_off = koord( i_off, j_off );
+		key.x_off = const_x_off;
+		key.y_off = const_y_off;
+		key.raster_width = IMG_SIZE;
+		key.underground_mode = grund_t::underground_mode;
+		key.underground_level = grund_t::underground_level;
+		key.min_height = welt->min_height;
+		key.max_height = welt->max_height;
+		key.water_stage = wasser_t::stage;
+		key.show_grid = grund_t::show_grid;
+		key.show_owner = obj_t::show_owner;
+		key.hide_under_cursor = env_t::hide_under_cursor;
+		key.draw_earth_border = env_t::draw_earth_border;
+		key.draw_outside_tile = env_t::draw_outside_tile;
+		key.day_night = display_get_day_night_color();
+		if(  key != ground_cache_key  ) {
+			display_ground_cache_invalidate();
+			ground_cache_key = key;
+		}
+	}
+
+	// the ground of a tile may reach this far above (walls) and below (borders) its position,
+	// and a changed tile may have been anywhere within this range before
+	const sint16 reach = tile_raster_scale_y( (welt->max_height - welt->min_height + 2) * TILE_HEIGHT_STEP, IMG_SIZE );
+
+	// find the rows with visible ground and the tiles which changed since the last frame
 	for(  int y = y_min;  y < y_max;  y++  ) {
 		const sint16 ypos = y * (IMG_SIZE / 4) + const_y_off;
-		// plotted = we plotted something
+		// plotted = something is visible in this row
 		bool plotted = false;
 
 		for(  sint16 x = -2 - ((y  +dpy_width) & 1);  (x * (IMG_SIZE / 2) + const_x_off) < (lt.x + wh.x);  x += 2  ) {
@@ -309,38 +357,35 @@ void main_view_t::display_region( koord lt, koord wh, sint16 y_min, sint16 y_max
 				const koord pos(i, j);
 				if(  grund_t* const kb = welt->lookup_kartenboden(pos)  ) {
 					const sint16 yypos = ypos - tile_raster_scale_y( min( kb->get_hoehe(), hmax_ground ) * TILE_HEIGHT_STEP, IMG_SIZE );
-					if(  yypos - IMG_SIZE < lt.y + wh.y  &&  yypos + IMG_SIZE > lt.y  ) {
-						if(  env_t::hide_under_cursor  ) {
-							const bool saved_grid = grund_t::show_grid;
-							const uint32 cursor_dist = shortest_distance( pos, cursor_pos );
-							if(  cursor_dist <= env_t::cursor_hide_range + 2u  ) {
-								kb->set_flag( grund_t::dirty );
-								if(  cursor_dist <= env_t::cursor_hide_range  ) {
-									grund_t::show_grid = true;
-								}
+					bool changed = false;
+					if(  env_t::hide_under_cursor  ) {
+						if(  shortest_distance( pos, cursor_pos ) <= env_t::cursor_hide_range + 2u  ) {
+							kb->set_flag( grund_t::dirty );
+						}
+						changed = cursor_pos != last_cursor_pos  &&  shortest_distance( pos, last_cursor_pos ) <= env_t::cursor_hide_range + 2u;
+					}
+					if(  cached  ) {
+						if(  !changed  &&  !kb->get_flag( grund_t::dirty )  ) {
+							// ways are drawn with the ground
+							for(  int n = 0;  n < 2  &&  !changed;  n++  ) {
+								const weg_t *w = kb->get_weg_nr( n );
+								changed = w  &&  w->get_flag( obj_t::dirty );
 							}
-							kb->display_if_visible( xpos, yypos, IMG_SIZE );
-							grund_t::show_grid = saved_grid;
 						}
 						else {
-							kb->display_if_visible( xpos, yypos, IMG_SIZE );
+							changed = true;
+						}
+						if(  changed  ) {
+							display_ground_cache_mark_dirty( xpos - IMG_SIZE / 2, yypos - 2 * reach, 2 * IMG_SIZE, IMG_SIZE + 4 * reach );
 						}
-
-						plotted = true;
-
 					}
-					// not on screen? We still might need to plot the border ...
-					else if(  env_t::draw_earth_border  &&  (pos.x-welt->get_size().x+1 == 0  ||  pos.y-welt->get_size().y+1 == 0)  ) {
-						kb->display_border( xpos, yypos, IMG_SIZE  CLIP_NUM_PAR);
+					if(  yypos - IMG_SIZE < lt.y + wh.y  &&  yypos + IMG_SIZE > lt.y  ) {
+						plotted = true;
 					}
 				}
 				else {
 					// check if outside visible
 					outside_visible = true;
-					if(  env_t::draw_outside_tile  ) {
-						const sint16 yypos = ypos - tile_raster_scale_y( welt->min_height * TILE_HEIGHT_STEP, IMG_SIZE );
-						display_normal(ground_desc_t::outside->get_image(0), xpos, yypos, 0);
-					}
 				}
 			}
 		}
@@ -357,6 +402,19 @@ void main_view_t::display_region( koord lt, koord wh, sint16 y_min, sint16 y_max
 			}
 		}
 	}
+	last_cursor_pos = cursor_pos;
+
+	if(  cached  ) {
+		scr_rect chunk;
+		while(  display_ground_cache_next_chunk( chunk )  ) {
+			display_ground( lt, wh, chunk, ground_y_min, y_max );
+		}
+		display_ground_cache_end();
+		display_set_color( display_get_day_night_color() );
+	}
+	else {
+		display_ground( lt, wh, area, ground_y_min, y_max );
+	}
 
 	// and then things (and other ground)
 	// especially necessary for vehicles
@@ -431,6 +489,78 @@ void main_view_t::display_region( koord lt, koord wh, sint16 y_min, sint16 y_max
 }
 
 
+void main_view_t::display_ground( koord lt, koord wh, const scr_rect &clip, sint16 y_min, sint16 y_max )
+{
+	const sint16 IMG_SIZE = get_tile_raster_width();
+
+	const int i_off = viewport->get_world_position().x + viewport->get_viewport_ij_offset().x;
+	const int j_off = viewport->get_world_position().y + viewport->get_viewport_ij_offset().y;
+	const int const_x_off = viewport->get_x_off();
+	const int const_y_off = viewport->get_y_off();
+
+	const int dpy_width = max(display_get_width(), display_get_fb_width()) / IMG_SIZE + 2;
+
+	// to save calls to grund_t::get_disp_height
+	const sint8 hmax_ground = (grund_t::underground_mode == grund_t::ugm_level) ? grund_t::underground_level : 127;
+
+	const koord cursor_pos = welt->get_zeiger() ? welt->get_zeiger()->get_pos().get_2d() : koord(-1000, -1000);
+
+	// see display_region()
+	const sint16 reach = tile_raster_scale_y( (welt->max_height - welt->min_height + 2) * TILE_HEIGHT_STEP, IMG_SIZE );
+	const sint16 ypos_highest = tile_raster_scale_y( min( welt->max_height, hmax_ground ) * TILE_HEIGHT_STEP, IMG_SIZE );
+	const sint16 ypos_lowest = tile_raster_scale_y( min( welt->min_height, hmax_ground ) * TILE_HEIGHT_STEP, IMG_SIZE );
+
+	for(  int y = y_min;  y < y_max;  y++  ) {
+		const sint16 ypos = y * (IMG_SIZE / 4) + const_y_off;
+
+		if(  ypos - ypos_highest - reach - IMG_SIZE >= clip.get_bottom()  ||  ypos - ypos_lowest + IMG_SIZE + reach <= clip.y  ) {
+			// nothing in this row can reach the clip rectangle
+			continue;
+		}
+
+		for(  sint16 x = -2 - ((y  +dpy_width) & 1);  (x * (IMG_SIZE / 2) + const_x_off) < (lt.x + wh.x);  x += 2  ) {
+			const sint16 i = ((y + x) >> 1) + i_off;
+			const sint16 j = ((y - x) >> 1) + j_off;
+			const sint16 xpos = x * (IMG_SIZE / 2) + const_x_off;
+
+			if(  xpos + IMG_SIZE > lt.x  &&  xpos + IMG_SIZE + IMG_SIZE / 2 > clip.x  ) {
+				if(  xpos - IMG_SIZE / 2 >= clip.get_right()  ) {
+					break;
+				}
+				const koord pos(i, j);
+				if(  grund_t* const kb = welt->lookup_kartenboden(pos)  ) {
+					const sint16 yypos = ypos - tile_raster_scale_y( min( kb->get_hoehe(), hmax_ground ) * TILE_HEIGHT_STEP, IMG_SIZE );
+					if(  yypos - reach - IMG_SIZE >= clip.get_bottom()  ||  yypos + IMG_SIZE + reach <= clip.y  ) {
+						continue;
+					}
+					if(  yypos - IMG_SIZE < lt.y + wh.y  &&  yypos + IMG_SIZE > lt.y  ) {
+						if(  env_t::hide_under_cursor  ) {
+							const bool saved_grid = grund_t::show_grid;
+							if(  shortest_distance( pos, cursor_pos ) <= env_t::cursor_hide_range  ) {
+								grund_t::show_grid = true;
+							}
+							kb->display_if_visible( xpos, yypos, IMG_SIZE );
+							grund_t::show_grid = saved_grid;
+						}
+						else {
+							kb->display_if_visible( xpos, yypos, IMG_SIZE );
+						}
+					}
+					// not on screen? We still might need to plot the border ...
+					else if(  env_t::draw_earth_border  &&  (pos.x-welt->get_size().x+1 == 0  ||  pos.y-welt->get_size().y+1 == 0)  ) {
+						kb->display_border( xpos, yypos, IMG_SIZE  CLIP_NUM_PAR);
+					}
+				}
+				else if(  env_t::draw_outside_tile  ) {
+					const sint16 yypos = ypos - tile_raster_scale_y( welt->min_height * TILE_HEIGHT_STEP, IMG_SIZE );
+					display_normal(ground_desc_t::outside->get_image(0), xpos, yypos, 0);
+				}
+			}
+		}
+	}
+}
+
+
 void main_view_t::display_background( scr_coord_val xp, scr_coord_val yp, scr_coord_val w, scr_coord_val h, bool dirty )
 {
 	if(  !(env_t::draw_earth_border  &&  env_t::draw_outside_tile)  ) {
@@ -29,6 +29,27 @@ private:
 	/// Cached value from last display run to determine if the background was visible, we'll save redraws if it was not.
 	bool outside_visible;
 
+	/// Everything besides the tiles the cached ground depends on; if any of it changes, all of the ground is drawn again.
+	struct ground_cache_key_t
+	{
+		koord ij_off;
+		sint16 x_off, y_off;
+		sint16 raster_width;
+		uint8 underground_mode;
+		sint8 underground_level;
+		sint8 min_height, max_height;
+		int water_stage;
+		bool show_grid, show_owner, hide_under_cursor;
+		bool draw_earth_border, draw_outside_tile;
+		rgba_t day_night;
+
+		bool operator !=(const ground_cache_key_t &k) const;
+	};
+	ground_cache_key_t ground_cache_key;
+
+	/// Cursor position of the last display run, the ground around it must be redrawn when objects are hidden under the cursor.
+	koord last_cursor_pos;
+
 public:
 	main_view_t(karte_t *welt);
 
@@ -65,6 +86,12 @@ public:
 	void display_region( koord lt, koord wh, sint16 y_min, const sint16 y_max, bool force_dirty );
 
 private:
+	/**
+	 * Draws the ground (and ways) of the rows y_min to y_max inside the rectangle lt, wh,
+	 * but only of the tiles that could reach the clip rectangle.
+	 */
+	void display_ground( koord lt, koord wh, const scr_rect &clip, sint16 y_min, sint16 y_max );
+
 	/**
 	 * Draws background in the specified rectangular screen coordinates.
 	 * @param xp X screen coordinate of the left-top corner.
@@ -469,6 +469,12 @@ grund_t::grund_t(koord3d pos)
 }
 
 
+void grund_t::update_tile_info() const
+{
+	welt->update_tile_info( pos.get_2d() );
+}
+
+
 grund_t::~grund_t()
 {
 	destroy_win((ptrdiff_t)this);
@@ -576,6 +582,8 @@ void grund_t::take_obj_from(grund_t* other_gr)
 		flags |= has_way2;
 		other_gr->clear_flag(has_way2);
 	}
+	tile_info_changed();
+	other_gr->tile_info_changed();
 }
 
 
@@ -669,6 +677,8 @@ void grund_t::set_halt(halthandle_t halt)
 		flags &= ~is_halt_flag;
 		flags |= dirty;
 	}
+	haltestelle_t::layout_changed();
+	tile_info_changed();
 }
 
 
@@ -2014,6 +2024,7 @@ sint64 grund_t::neuen_weg_bauen(weg_t *weg, ribi_t::ribi ribi, player_t *player)
 
 		// may result in a crossing, but the wegebauer will recalc all images anyway
 		weg->calc_image();
+		tile_info_changed();
 	}
 	return cost;
 }
@@ -2064,6 +2075,7 @@ sint32 grund_t::weg_entfernen(waytype_t wegtyp, bool ribi_rem)
 		else {
 			flags &= ~has_way1;
 		}
+		tile_info_changed();
 
 		calc_image();
 		minimap_t::get_instance()->calc_map_pixel(get_pos().get_2d());
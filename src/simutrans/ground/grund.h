@@ -229,6 +229,15 @@ protected:
 	// calculates the slope image and sets the draw_as_obj flag correctly
 	void calc_back_image(const sint8 hgt,const slope_t::type slope_this);
 
+	/// the ground of a tile changed, so the copy of its data in the world must be updated
+	inline void tile_info_changed() const {
+		if(  flags & is_kartenboden  ) {
+			update_tile_info();
+		}
+	}
+
+	void update_tile_info() const;
+
 	// this is the real image calculation, called for the actual ground image
 	virtual void calc_image_internal(const bool calc_only_snowline_change) = 0;
 
@@ -418,11 +427,11 @@ public:
 	*/
 	inline const koord3d& get_pos() const { return pos; }
 
-	inline void set_pos(koord3d newpos) { pos = newpos;}
+	inline void set_pos(koord3d newpos) { pos = newpos; tile_info_changed(); }
 
 	// slope are now maintained locally
 	slope_t::type get_grund_hang() const { return slope; }
-	void set_grund_hang(slope_t::type sl) { slope = sl; }
+	void set_grund_hang(slope_t::type sl) { slope = sl; tile_info_changed(); }
 
 	/**
 	 * some ground tiles may be part of halts.
@@ -462,7 +471,7 @@ public:
 		}
 	}
 
-	void set_hoehe(sint8 h) { pos.z = h;}
+	void set_hoehe(sint8 h) { pos.z = h; tile_info_changed(); }
 
 	// Helper functions for underground modes
 	//
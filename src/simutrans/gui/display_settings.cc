@@ -14,6 +14,7 @@
 #include "../dataobj/settings.h"
 #include "../dataobj/environment.h"
 #include "../dataobj/translator.h"
+#include "../dataobj/step_arena.h"
 #include "../obj/baum.h"
 #include "../obj/zeiger.h"
 #include "../display/simgraph.h"
@@ -25,6 +26,7 @@
 #include "gui_theme.h"
 #include "themeselector.h"
 #include "loadfont_frame.h"
+#include "perf_frame.h"
 #include "simwin.h"
 
 // display text label in player colors
@@ -53,6 +55,7 @@ enum {
 	IDBTN_CHANGE_FONT,
 	IDBTN_INFINITE_SCROLL,
 	IDBTN_LEFTDRAG_MINIMAP,
+	IDBTN_SHOW_TIMINGS,
 	COLORS_MAX_BUTTONS
 };
 
@@ -162,6 +165,15 @@ gui_settings_t::gui_settings_t()
 	simloops_value_label.buf().printf(" 999.9");
 	simloops_value_label.update();
 	add_component( &simloops_value_label, 2 );
+	// Scratch memory of the last step
+	new_component<gui_label_t>("Step scratch:");
+	scratch_value_label.buf().printf(" 99999 / 9999 KiB");
+	scratch_value_label.update();
+	add_component( &scratch_value_label, 2 );
+
+	// Timings of the main loop
+	buttons[ IDBTN_SHOW_TIMINGS ].init( button_t::roundbox_state | button_t::flexible, "Timings" );
+	add_component( buttons + IDBTN_SHOW_TIMINGS, 3 );
 }
 
 void gui_settings_t::draw(scr_coord offset)
@@ -198,6 +210,11 @@ void gui_settings_t::draw(scr_coord offset)
 	simloops_value_label.buf().printf(" %d%c%d", loops/10, get_fraction_sep(), loops%10 );
 	simloops_value_label.update();
 
+	// allocations from the step arena and their size
+	const step_arena_t &arena = step_arena_t::get_instance();
+	scratch_value_label.buf().printf(" %u / %u KiB", arena.get_last_step_allocations(), (uint32)((arena.get_last_step_bytes()+1023)/1024) );
+	scratch_value_label.update();
+
 	// All components are updated, now draw them...
 	gui_aligned_container_t::draw(offset);
 }
@@ -742,6 +759,9 @@ bool color_gui_t::action_triggered( gui_action_creator_t *comp, value_t)
 	case IDBTN_CHANGE_FONT:
 		create_win( new loadfont_frame_t(), w_info, magic_font );
 		break;
+	case IDBTN_SHOW_TIMINGS:
+		create_win( new perf_frame_t(), w_info, magic_perf_timings );
+		break;
 	default:
 		assert( 0 );
 	}
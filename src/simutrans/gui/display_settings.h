@@ -30,7 +30,8 @@ private:
 		frame_time_value_label,
 		idle_time_value_label,
 		fps_value_label,
-		simloops_value_label;
+		simloops_value_label,
+		scratch_value_label;
 
 public:
 	button_t toolbar_pos, reselect_closes_tool, single_toolbar, fullscreen, borderless;
@@ -26,6 +26,7 @@
 #include "../dataobj/powernet.h"
 #include "../dataobj/ribi.h"
 #include "../dataobj/loadsave.h"
+#include "../dataobj/environment.h"
 
 #include "../obj/way/schiene.h"
 #include "../obj/leitung2.h"
@@ -43,6 +44,10 @@
 
 #include <math.h>
 
+#ifdef MULTI_THREAD
+#include "../utils/simthread.h"
+#endif
+
 sint32 minimap_t::max_cargo=0;
 sint32 minimap_t::max_passed=0;
 
@@ -638,7 +643,15 @@ void minimap_t::full_redraw()
 
     if(is_visible)
     {
-        scr_size minimap_size ( min( get_size().w, new_size.w ), min( get_size().h, new_size.h ) );
+        // the flat view recalculates the visible tiles when drawing
+        invalidate_map_tiles();
+
+        if(!isometric) {
+            cur_off = new_off;
+            cur_size = new_size;
+            needs_redraw = false;
+            return;
+        }
 
         if(map_texture == NULL) {
             dbg->message("minimap_t::full_redraw()", "Allocating a new map texture");
@@ -653,55 +666,218 @@ void minimap_t::full_redraw()
         needs_redraw = false;
 
 
-        // redraw the map
-        if(isometric) {
-            map_tex_cur_width = new_size.w;
-            map_tex_cur_height = new_size.h;            
-            uint8_t * pixels = (uint8_t *)calloc(new_size.w * new_size.h * 4, 1);
+        // redraw the isometric map
+        map_tex_cur_width = new_size.w;
+        map_tex_cur_height = new_size.h;
+        uint8_t * pixels = (uint8_t *)calloc(new_size.w * new_size.h * 4, 1);
 
-            koord k;
-            for(  k.y=0;  k.y < world->get_size().y;  k.y++  ) {
-                for(  k.x=0;  k.x < world->get_size().x;  k.x++  ) {
-                    rgb888_t color = calc_map_pixel_color(k);
+        koord k;
+        for(  k.y=0;  k.y < world->get_size().y;  k.y++  ) {
+            for(  k.x=0;  k.x < world->get_size().x;  k.x++  ) {
+                rgb888_t color = calc_map_pixel_color(k);
 
-                    int x = (k.x - k.y);
-                    int y = (k.x + k.y) / 2;
+                int x = (k.x - k.y);
+                int y = (k.x + k.y) / 2;
 
-                    tex_setpix(pixels, new_size.w, new_size.h, 
-                               x + world->get_size().x - cur_off.x, y - cur_off.y, color);
-                }
+                tex_setpix(pixels, new_size.w, new_size.h,
+                           x + world->get_size().x - cur_off.x, y - cur_off.y, color);
             }
-            map_texture->update_region(0, 0, new_size.w, new_size.h, pixels);
-            free(pixels);
-        }
-        else {
-            map_tex_cur_width = new_size.w;
-            map_tex_cur_height = new_size.h;            
-            uint8_t * pixels = (uint8_t *)calloc(new_size.w * new_size.h * 4, 1);
-            
-            koord k;
-            koord start_off = koord( (cur_off.x*zoom_out)/zoom_in, (cur_off.y*zoom_out)/zoom_in );
-            koord end_off = start_off+koord((minimap_size.w*zoom_out)/zoom_in+1, (minimap_size.h*zoom_out)/zoom_in+1);
-            for(  k.y=start_off.y;  k.y<end_off.y;  k.y+=zoom_out  ) {
-                for(  k.x=start_off.x;  k.x<end_off.x;  k.x+=zoom_out  ) {
-
-                    // dbg->message("minimap_t::full_redraw()", "k = %d %d", k.x, k.y);
-
-                    rgb888_t color = calc_map_pixel_color(k);
-                    int x = k.x - start_off.x;
-                    int y = k.y - start_off.y;
-
-                    tex_setpix(pixels, new_size.w, new_size.h, x/zoom_out, y/zoom_out, color);
-                }
-            }
-
-            map_texture->update_region(0, 0, new_size.w, new_size.h, pixels);
-            free(pixels);
         }
+        map_texture->update_region(0, 0, new_size.w, new_size.h, pixels);
+        free(pixels);
     }
 }
 
 
+void minimap_t::free_map_tiles()
+{
+	for(  sint32 i = 0;  i < map_tiles_x*map_tiles_y;  i++  ) {
+		free( map_tiles[i].pixels );
+		gl_texture_t::destroy_texture( map_tiles[i].texture );
+	}
+	delete [] map_tiles;
+	map_tiles = NULL;
+	map_tiles_x = map_tiles_y = 0;
+}
+
+
+void minimap_t::invalidate_map_tiles()
+{
+	for(  sint32 i = 0;  i < map_tiles_x*map_tiles_y;  i++  ) {
+		map_tiles[i].stale = true;
+	}
+}
+
+
+void minimap_t::calc_map_tile(sint16 tx, sint16 ty)
+{
+	map_tile_t &tile = map_tiles[ty*map_tiles_x + tx];
+	if(  tile.pixels == NULL  ) {
+		// outside of the map stays transparent
+		tile.pixels = (uint8 *)calloc( MINIMAP_TILE_SIZE*MINIMAP_TILE_SIZE*4, 1 );
+	}
+
+	const koord origin( tx*MINIMAP_TILE_SIZE, ty*MINIMAP_TILE_SIZE );
+	const sint16 w = min( MINIMAP_TILE_SIZE, world->get_size().x - origin.x );
+	const sint16 h = min( MINIMAP_TILE_SIZE, world->get_size().y - origin.y );
+	for(  sint16 y = 0;  y < h;  y++  ) {
+		uint8 *p = tile.pixels + y*MINIMAP_TILE_SIZE*4;
+		for(  sint16 x = 0;  x < w;  x++  ) {
+			const rgb888_t color = calc_map_pixel_color( origin + koord( x, y ) );
+			*p++ = color.r;
+			*p++ = color.g;
+			*p++ = color.b;
+			*p++ = 255;
+		}
+	}
+	tile.stale = false;
+	tile.dirty_min = 0;
+	tile.dirty_max = h-1;
+}
+
+
+void minimap_t::upload_map_tile(map_tile_t &tile, uint8 level)
+{
+	const sint16 size = MINIMAP_TILE_SIZE >> level;
+	if(  tile.texture == NULL  ||  tile.texture_level != level  ) {
+		gl_texture_t::destroy_texture( tile.texture );
+		tile.texture = gl_texture_t::create_texture( size, size, NULL );
+		tile.texture_level = level;
+		tile.dirty_min = 0;
+		tile.dirty_max = MINIMAP_TILE_SIZE-1;
+	}
+	if(  tile.dirty_min > tile.dirty_max  ) {
+		return;
+	}
+
+	if(  level == 0  ) {
+		tile.texture->update_region( 0, tile.dirty_min, size, tile.dirty_max-tile.dirty_min+1, tile.pixels + tile.dirty_min*MINIMAP_TILE_SIZE*4 );
+	}
+	else {
+		// average over step x step squares
+		const sint16 step = 1 << level;
+		const sint16 row_min = tile.dirty_min >> level;
+		const sint16 rows = (tile.dirty_max >> level) - row_min + 1;
+		uint8 *reduced = (uint8 *)malloc( size*rows*4 );
+		uint8 *out = reduced;
+		for(  sint16 r = row_min;  r < row_min+rows;  r++  ) {
+			for(  sint16 c = 0;  c < size;  c++  ) {
+				uint32 sum[4] = { 0, 0, 0, 0 };
+				for(  sint16 y = r*step;  y < (r+1)*step;  y++  ) {
+					const uint8 *in = tile.pixels + (y*MINIMAP_TILE_SIZE + c*step)*4;
+					for(  sint16 x = 0;  x < step*4;  x++  ) {
+						sum[x&3] += in[x];
+					}
+				}
+				for(  int i = 0;  i < 4;  i++  ) {
+					*out++ = sum[i] >> (2*level);
+				}
+			}
+		}
+		tile.texture->update_region( 0, row_min, size, rows, reduced );
+		free( reduced );
+	}
+	tile.dirty_min = MINIMAP_TILE_SIZE;
+	tile.dirty_max = -1;
+}
+
+
+// helper for the parallel recalculation of the minimap tiles
+struct calc_map_tiles_param_t
+{
+	minimap_t *map;
+	const vector_tpl<koord> *tiles;
+	uint32 first, last;
+};
+
+
+void *minimap_t::calc_map_tiles_thread(void *ptr)
+{
+	const calc_map_tiles_param_t *param = reinterpret_cast<const calc_map_tiles_param_t *>(ptr);
+	for(  uint32 i = param->first;  i < param->last;  i++  ) {
+		const koord t = (*param->tiles)[i];
+		param->map->calc_map_tile( t.x, t.y );
+	}
+	return NULL;
+}
+
+
+void minimap_t::draw_map_tiles(scr_coord pos)
+{
+	// reduced resolution when zoomed out
+	uint8 level = 0;
+	while(  level+1 < MINIMAP_TILE_LEVELS  &&  (2 << level) <= zoom_out  ) {
+		level++;
+	}
+
+	// only the visible tiles
+	const koord vis_min = screen_to_map_coord( cur_off );
+	const koord vis_max = screen_to_map_coord( cur_off + scr_coord( cur_size.w, cur_size.h ) );
+	const sint16 tx_min = clamp( vis_min.x / MINIMAP_TILE_SIZE, 0, map_tiles_x-1 );
+	const sint16 ty_min = clamp( vis_min.y / MINIMAP_TILE_SIZE, 0, map_tiles_y-1 );
+	const sint16 tx_max = clamp( vis_max.x / MINIMAP_TILE_SIZE, 0, map_tiles_x-1 );
+	const sint16 ty_max = clamp( vis_max.y / MINIMAP_TILE_SIZE, 0, map_tiles_y-1 );
+
+	vector_tpl<koord> stale;
+	for(  sint16 ty = ty_min;  ty <= ty_max;  ty++  ) {
+		for(  sint16 tx = tx_min;  tx <= tx_max;  tx++  ) {
+			if(  map_tiles[ty*map_tiles_x + tx].stale  ) {
+				stale.append( koord( tx, ty ) );
+			}
+		}
+	}
+
+#ifdef MULTI_THREAD
+	// the modes with running maxima update them during the calculation
+	const bool parallel = env_t::num_threads > 1  &&  stale.get_count() > 1  &&  (mode & (MAP_FREIGHT|MAP_TRAFFIC|MAP_LEVEL)) == 0;
+	if(  parallel  ) {
+		// nothing in the world changes while we are drawing
+		const uint32 count = min( (uint32)env_t::num_threads, stale.get_count() );
+		calc_map_tiles_param_t param[MAX_THREADS];
+		pthread_t thread[MAX_THREADS];
+		bool started[MAX_THREADS];
+		for(  uint32 t = 0;  t < count;  t++  ) {
+			param[t].map = this;
+			param[t].tiles = &stale;
+			param[t].first = (t * stale.get_count()) / count;
+			param[t].last = ((t + 1) * stale.get_count()) / count;
+		}
+		for(  uint32 t = 1;  t < count;  t++  ) {
+			started[t] = pthread_create( &thread[t], NULL, calc_map_tiles_thread, (void *)&param[t] ) == 0;
+		}
+		calc_map_tiles_thread( &param[0] );
+		for(  uint32 t = 1;  t < count;  t++  ) {
+			if(  started[t]  ) {
+				pthread_join( thread[t], NULL );
+			}
+			else {
+				calc_map_tiles_thread( &param[t] );
+			}
+		}
+	}
+	else
+#endif
+	{
+		for(koord const& t : stale) {
+			calc_map_tile( t.x, t.y );
+		}
+	}
+
+	display_set_color(RGBA_WHITE);
+	for(  sint16 ty = ty_min;  ty <= ty_max;  ty++  ) {
+		for(  sint16 tx = tx_min;  tx <= tx_max;  tx++  ) {
+			map_tile_t &tile = map_tiles[ty*map_tiles_x + tx];
+			upload_map_tile( tile, level );
+
+			const scr_coord tl = map_to_screen_coord( koord( tx*MINIMAP_TILE_SIZE, ty*MINIMAP_TILE_SIZE ) );
+			const scr_coord br = map_to_screen_coord( koord( (tx+1)*MINIMAP_TILE_SIZE, (ty+1)*MINIMAP_TILE_SIZE ) );
+			display_tile_from_sheet( tile.texture, pos.x + tl.x, pos.y + tl.y, br.x - tl.x, br.y - tl.y,
+			                         0, 0, tile.texture->width, tile.texture->height );
+		}
+	}
+}
+
+
 /**
  * Opposed to full_redraw() this tries to do efficient updates
  * of pixel size spots of the map
@@ -726,7 +902,26 @@ void minimap_t::set_map_color(koord k, const rgb888_t color)
 	// if map is in normal mode, set new color for map
 	// otherwise do nothing
 	// result: convois will not "paint over" special maps
-	if(map_texture == NULL || !world->is_within_limits(k)) {
+	if(!world->is_within_limits(k)) {
+		return;
+	}
+
+	// the flat view, uploaded when drawn
+	if(  map_tiles  &&  k.x/MINIMAP_TILE_SIZE < map_tiles_x  &&  k.y/MINIMAP_TILE_SIZE < map_tiles_y  ) {
+		map_tile_t &tile = map_tiles[(k.y/MINIMAP_TILE_SIZE)*map_tiles_x + k.x/MINIMAP_TILE_SIZE];
+		if(  !tile.stale  ) {
+			const sint16 row = k.y % MINIMAP_TILE_SIZE;
+			uint8 *p = tile.pixels + (row*MINIMAP_TILE_SIZE + k.x % MINIMAP_TILE_SIZE)*4;
+			p[0] = color.r;
+			p[1] = color.g;
+			p[2] = color.b;
+			p[3] = 255;
+			tile.dirty_min = min( tile.dirty_min, row );
+			tile.dirty_max = max( tile.dirty_max, row );
+		}
+	}
+
+	if(map_texture == NULL || !isometric) {
 		return;
 	}
 
@@ -755,9 +950,6 @@ void minimap_t::set_map_color(koord k, const rgb888_t color)
 			}
 		}
 	}
-	else {
-        set_map_color_clip(k.x - cur_off.x/zoom_in, k.y - cur_off.y/zoom_in, color);
-	}
 }
 
 
@@ -1061,7 +1253,10 @@ rgb888_t minimap_t::calc_map_pixel(const grund_t *gr)
 
 void minimap_t::set_xy_offset_size(const scr_coord off, const scr_size size) 
 {
-    needs_redraw = (new_off != off) || (new_size != size);
+    // only the isometric view is drawn for the visible part
+    if(isometric && ((new_off != off) || (new_size != size))) {
+        needs_redraw = true;
+    }
 
     new_off = off;
     new_size = size;
@@ -1192,13 +1387,18 @@ scr_size minimap_t::get_max_size() const
 void minimap_t::calc_map_size()
 {
 	set_size( get_max_size() ); // of the gui_component to adjust scroll bars
-	needs_redraw = true;
+	// the flat view uses the same colours at any zoom
+	if(  isometric  ) {
+		needs_redraw = true;
+	}
 }
 
 
 minimap_t::minimap_t()
 {
 	map_texture = NULL;
+	map_tiles = NULL;
+	map_tiles_x = map_tiles_y = 0;
 	zoom_in = 1;
 	zoom_out = 1;
 	isometric = false;
@@ -1216,6 +1416,7 @@ minimap_t::~minimap_t()
 {
     dbg->message("minimap_t::~minimap_t()", "Called.");
 	// todo: delete map_data;
+	free_map_tiles();
 }
 
 
@@ -1235,6 +1436,19 @@ void minimap_t::init()
 	// delete map_data;
 	// map_data = NULL;
 
+	free_map_tiles();
+	map_tiles_x = (world->get_size().x + MINIMAP_TILE_SIZE - 1) / MINIMAP_TILE_SIZE;
+	map_tiles_y = (world->get_size().y + MINIMAP_TILE_SIZE - 1) / MINIMAP_TILE_SIZE;
+	map_tiles = new map_tile_t[map_tiles_x*map_tiles_y];
+	for(  sint32 i = 0;  i < map_tiles_x*map_tiles_y;  i++  ) {
+		map_tiles[i].pixels = NULL;
+		map_tiles[i].texture = NULL;
+		map_tiles[i].texture_level = 0;
+		map_tiles[i].stale = true;
+		map_tiles[i].dirty_min = MINIMAP_TILE_SIZE;
+		map_tiles[i].dirty_max = -1;
+	}
+
 	needs_redraw = true;
 
 	calc_map_size();
@@ -1359,7 +1573,13 @@ void minimap_t::draw(scr_coord pos)
 		new_size = cur_size;
 	}
 
-    if(new_off != cur_off)
+    if(!isometric)
+    {
+		// tiles are drawn where needed
+		cur_off = new_off;
+		cur_size = new_size;
+    }
+    else if(new_off != cur_off)
     {
 		needs_redraw = true;
     }
@@ -1396,7 +1616,7 @@ void minimap_t::draw(scr_coord pos)
 		full_redraw();
 	}
 
-	if(map_texture == NULL) {
+	if(  isometric ? map_texture == NULL : map_tiles == NULL  ) {
 		return;
 	}
 
@@ -1432,11 +1652,16 @@ void minimap_t::draw(scr_coord pos)
 
     display_set_color(RGBA_BLACK);
     display_fillbox_wh(pos.x + cur_off.x, pos.y + cur_off.y, cur_size.w, cur_size.h);
-    display_set_color(RGBA_WHITE);
-	display_tile_from_sheet(map_texture, 
-                            pos.x + cur_off.x, pos.y + cur_off.y, 
-                            map_texture->width * zoom_in / zoom_out, map_texture->height * zoom_in / zoom_out,
-	                        0, 0, map_texture->width, map_texture->height);
+    if(isometric) {
+        display_set_color(RGBA_WHITE);
+        display_tile_from_sheet(map_texture,
+                                pos.x + cur_off.x, pos.y + cur_off.y,
+                                map_texture->width * zoom_in / zoom_out, map_texture->height * zoom_in / zoom_out,
+                                0, 0, map_texture->width, map_texture->height);
+    }
+    else {
+        draw_map_tiles(pos);
+    }
 
 	if(  !current_cnv.is_bound()  &&  mode & MAP_LINES    ) {
 		vector_tpl<linehandle_t> linee;
@@ -27,6 +27,11 @@ class gl_texture_t;
 
 #define MAX_SEVERITY_COLORS 10
 
+/// edge length of a minimap tile in map squares
+#define MINIMAP_TILE_SIZE 256
+/// number of reduced resolutions of a tile (halving the size each)
+#define MINIMAP_TILE_LEVELS 5
+
 
 /**
  * This class is used to render the actual minimap.
@@ -74,9 +79,42 @@ private:
 
 	static minimap_t *single_instance;
 
-	/// the terrain map
+	/// the terrain map (isometric view)
 	gl_texture_t *map_texture;
 
+	/**
+	 * The flat view is kept as square tiles of MINIMAP_TILE_SIZE map squares
+	 * with one pixel per square. Only the visible tiles are recalculated
+	 * (after a mode change) and only their changed rows are uploaded.
+	 * Zoomed out, a tile is uploaded with reduced resolution.
+	 */
+	struct map_tile_t
+	{
+		uint8 *pixels;             ///< RGBA
+		gl_texture_t *texture;
+		uint8 texture_level;       ///< resolution of texture is MINIMAP_TILE_SIZE >> texture_level
+		bool stale;                ///< colours must be recalculated
+		sint16 dirty_min, dirty_max; ///< rows changed since the last upload, none if min > max
+	};
+	map_tile_t *map_tiles;
+	sint16 map_tiles_x, map_tiles_y;
+
+	void free_map_tiles();
+
+	/// marks all tiles for recalculation
+	void invalidate_map_tiles();
+
+	/// recalculates all colours of a tile
+	void calc_map_tile(sint16 tx, sint16 ty);
+
+	/// uploads the changed rows of a tile
+	void upload_map_tile(map_tile_t &tile, uint8 level);
+
+	/// draws the flat view
+	void draw_map_tiles(scr_coord pos);
+
+	static void *calc_map_tiles_thread(void *);
+
 	/**
 	 * Opposed to full_redraw() this tries to do efficient updates
 	 * of pixel size spots of the map
@@ -0,0 +1,68 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include "perf_frame.h"
+#include "simwin.h"
+#include "../dataobj/translator.h"
+#include "../utils/perf_timer.h"
+
+
+// written to the user directory
+#define TRACE_FILENAME "trace.json"
+
+
+perf_frame_t::perf_frame_t() :
+	gui_frame_t( translator::translate("Timings") ),
+	txt(&buf)
+{
+	set_table_layout(1,0);
+
+	trace.init( button_t::roundbox_state | button_t::flexible, "Record trace" );
+	trace.set_tooltip( "Writes all timed calls to trace.json, to be viewed with about://tracing or Perfetto" );
+	trace.pressed = perf_timer_t::is_tracing();
+	trace.add_listener(this);
+	add_component(&trace);
+
+	perf_timer_t::print_stats(buf);
+	txt.recalc_size();
+	add_component(&txt);
+
+	reset_min_windowsize();
+	set_windowsize(get_min_windowsize());
+}
+
+
+void perf_frame_t::draw(scr_coord pos, scr_size size)
+{
+	buf.clear();
+	perf_timer_t::print_stats(buf);
+	txt.recalc_size();
+	trace.pressed = perf_timer_t::is_tracing();
+
+	// grow with the number of timers shown
+	reset_min_windowsize();
+	const scr_size min = get_min_windowsize();
+	if(  size.w < min.w  ||  size.h < min.h  ) {
+		set_windowsize( scr_size( max(size.w, min.w), max(size.h, min.h) ) );
+		size = get_windowsize();
+	}
+
+	gui_frame_t::draw(pos, size);
+}
+
+
+bool perf_frame_t::action_triggered(gui_action_creator_t *comp, value_t)
+{
+	if(  comp == &trace  ) {
+		if(  perf_timer_t::is_tracing()  ) {
+			perf_timer_t::stop_trace( TRACE_FILENAME );
+		}
+		else {
+			perf_timer_t::start_trace();
+		}
+		trace.pressed = perf_timer_t::is_tracing();
+	}
+	return true;
+}
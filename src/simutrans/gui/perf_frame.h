@@ -0,0 +1,37 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef GUI_PERF_FRAME_H
+#define GUI_PERF_FRAME_H
+
+
+#include "gui_frame.h"
+#include "components/action_listener.h"
+#include "components/gui_button.h"
+#include "components/gui_textarea.h"
+#include "../utils/cbuffer.h"
+
+
+/**
+ * Shows the timings of the main loop (see perf_timer_t)
+ * and starts and stops the trace.
+ */
+class perf_frame_t : public gui_frame_t, action_listener_t
+{
+	cbuffer_t buf;
+	gui_textarea_t txt;
+	button_t trace;
+
+public:
+	perf_frame_t();
+
+	const char *get_help_filename() const OVERRIDE { return NULL; }
+
+	void draw(scr_coord pos, scr_size size) OVERRIDE;
+
+	bool action_triggered(gui_action_creator_t*, value_t) OVERRIDE;
+};
+
+#endif
@@ -80,7 +80,8 @@ private:
 	bool read_ppm(const char *filename);
 	bool read_png(const char *filename);
 
-	bool read_png_data(FILE *file);
+	/// @param filename only for error messages
+	bool read_png_data(FILE *file, const char *filename);
 
 private:
 	uint8 *data;
@@ -5,7 +5,6 @@
 
 #include "raw_image.h"
 
-#include <string>
 #include <png.h>
 #include <setjmp.h>
 #include <stdlib.h>
@@ -16,10 +15,7 @@
 #include "../simdebug.h"
 
 
-static std::string filename_;
-
-
-bool raw_image_t::read_png_data(FILE *file)
+bool raw_image_t::read_png_data(FILE *file, const char *filename)
 {
 	png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING,NULL,NULL,NULL);
 	if (png_ptr == NULL) {
@@ -36,7 +32,7 @@ bool raw_image_t::read_png_data(FILE *file)
 
 #ifdef PNG_SETJMP_SUPPORTED
 	if(  setjmp(png_jmpbuf(png_ptr)  )) {
-		dbg->error( "raw_image_t::read_png_data", "Fatal error in %s.", filename_.c_str());
+		dbg->error( "raw_image_t::read_png_data", "Fatal error in %s.", filename);
 		png_destroy_read_struct(&png_ptr, &info_ptr, (png_info**)0);
 		return false;
 	}
@@ -57,7 +53,7 @@ bool raw_image_t::read_png_data(FILE *file)
 	int color_type;
 
 	if (!png_get_IHDR(png_ptr, info_ptr, &new_width, &new_height, &bit_depth, &color_type, 0, 0, 0)) {
-		dbg->error("raw_image_t::read_png_data", "Failed to read IHDR from '%s'", filename_.c_str());
+		dbg->error("raw_image_t::read_png_data", "Failed to read IHDR from '%s'", filename);
 		png_destroy_read_struct(&png_ptr, &info_ptr, (png_info**)0);
 		return false;
 	}
@@ -86,7 +82,7 @@ bool raw_image_t::read_png_data(FILE *file)
 		color_type = PNG_COLOR_TYPE_RGBA;
 	}
 	else if (color_type == PNG_COLOR_TYPE_GA) {
-		dbg->warning("raw_image_t::read_png_data", "Ignoring alpha channel for grayscale image '%s'", filename_.c_str());
+		dbg->warning("raw_image_t::read_png_data", "Ignoring alpha channel for grayscale image '%s'", filename);
 		png_set_strip_alpha(png_ptr);
 		color_type = PNG_COLOR_TYPE_GRAY;
 	}
@@ -164,13 +160,10 @@ bool raw_image_t::read_png_data(FILE *file)
 
 bool raw_image_t::read_png(const char *fname)
 {
-	// remember the file name for better error messages.
-	filename_ = fname;
-
 	FILE* file = fopen(fname, "rb");
 
 	if (file) {
-		const bool ok = read_png_data(file);
+		const bool ok = read_png_data(file, fname);
 		fclose(file);
 		return ok;
 	}
@@ -183,9 +176,6 @@ bool raw_image_t::read_png(const char *fname)
 
 bool raw_image_t::write_png(const char *file_name) const
 {
-	// remember the file name for better error messages.
-	filename_ = file_name;
-
 	png_structp png_ptr = NULL;
 	png_infop info_ptr = NULL;
 	FILE *fp = fopen(file_name, "wb");
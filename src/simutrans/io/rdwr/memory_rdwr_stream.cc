@@ -0,0 +1,77 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include "memory_rdwr_stream.h"
+
+#include <cassert>
+#include <cstring>
+
+
+memory_rdwr_stream_t::memory_rdwr_stream_t() :
+	rdwr_stream_t(true),
+	data(NULL),
+	size(0),
+	capacity(0),
+	pos(0)
+{
+	status = STATUS_OK;
+}
+
+
+memory_rdwr_stream_t::memory_rdwr_stream_t(char *data_, size_t len) :
+	rdwr_stream_t(false),
+	data(data_),
+	size(len),
+	capacity(len),
+	pos(0)
+{
+	status = (len > 0) ? STATUS_OK : STATUS_EOF;
+}
+
+
+memory_rdwr_stream_t::~memory_rdwr_stream_t()
+{
+	delete [] data;
+}
+
+
+size_t memory_rdwr_stream_t::read(void *buf, size_t len)
+{
+	assert(!is_writing());
+
+	if (size - pos < len) {
+		len = size - pos;
+		status = STATUS_EOF;
+	}
+	if (len > 0) {
+		memcpy(buf, data + pos, len);
+		pos += len;
+	}
+	return len;
+}
+
+
+size_t memory_rdwr_stream_t::write(const void *buf, size_t len)
+{
+	assert(is_writing());
+
+	if (size + len > capacity) {
+		size_t new_capacity = capacity ? capacity * 2 : 4096;
+		while (new_capacity < size + len) {
+			new_capacity *= 2;
+		}
+		char *new_data = new char[new_capacity];
+		if (size > 0) {
+			memcpy(new_data, data, size);
+		}
+		delete [] data;
+		data = new_data;
+		capacity = new_capacity;
+	}
+
+	memcpy(data + size, buf, len);
+	size += len;
+	return len;
+}
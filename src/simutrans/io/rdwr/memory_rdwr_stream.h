@@ -0,0 +1,49 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef IO_RDWR_MEMORY_RDWR_STREAM_H
+#define IO_RDWR_MEMORY_RDWR_STREAM_H
+
+
+#include "rdwr_stream.h"
+
+
+/// Reads/writes data from/to a buffer in memory.
+class memory_rdwr_stream_t : public rdwr_stream_t
+{
+public:
+	/// For writing, the buffer grows as needed.
+	memory_rdwr_stream_t();
+
+	/// For reading @p len bytes from @p data.
+	/// Takes ownership of @p data, which must be allocated with new[].
+	memory_rdwr_stream_t(char *data, size_t len);
+
+	~memory_rdwr_stream_t();
+
+public:
+	/// @copydoc rdwr_stream_t::read
+	size_t read(void *buf, size_t len) OVERRIDE;
+
+	/// @copydoc rdwr_stream_t::write
+	size_t write(const void *buf, size_t len) OVERRIDE;
+
+	const char *get_data() const { return data; }
+
+	/// @returns number of bytes written (or total size of the buffer, when reading)
+	size_t get_size() const { return size; }
+
+	/// @returns number of bytes not yet read
+	size_t get_remaining() const { return size - pos; }
+
+private:
+	char *data;
+	size_t size;
+	size_t capacity;
+	size_t pos;
+};
+
+
+#endif
@@ -786,18 +786,22 @@ void nwc_sync_t::do_command(karte_t *welt)
 		env_t::restore_UI = true;
 		welt->save( fn, false, SERVER_SAVEGAME_VER_NR, false );
 
-		// ok, now sending game
+		// ok, now sending game while we reload it ourselves
 		// this sends nwc_game_t
-		const char *err = network_send_file( socket_list_t::get_socket(client_id), fn );
-		if (err) {
-			dbg->warning("nwc_sync_t::do_command","send game failed with: %s", err);
-		}
+		const char *err = network_send_file_start( socket_list_t::get_socket(client_id), fn );
 
 		uint32 old_sync_steps = welt->get_sync_steps();
 		welt->load( fn );
 		welt->type_of_generation = karte_t::LOADED_WORLD;
 		env_t::restore_UI = old_restore_UI;
 
+		if (err == NULL) {
+			err = network_send_file_finish();
+		}
+		if (err) {
+			dbg->warning("nwc_sync_t::do_command","send game failed with: %s", err);
+		}
+
 		// restore steps
 		welt->network_game_set_pause( false, old_sync_steps);
 
@@ -10,6 +10,7 @@
 
 #include <string.h>
 #include <errno.h>
+#include <assert.h>
 #include "../utils/cbuffer.h"
 
 #ifndef NETTOOL
@@ -38,12 +39,12 @@ const char *network_receive_file(const SOCKET src_sock, const char *const save_a
 #endif
 
 		// good place to show a progress bar
-		char rbuf[4096];
+		static char rbuf[65536];
 		sint32 length_read = 0;
 		if (FILE* const f = dr_fopen(save_as, "wb")) {
 			while(length_read < length) {
 				if(  timeout > 0  ) {
-					/** 10s for 4096 bytes:
+					/** 10s without any data:
 					 * As long as you are not connected with less than 1200 Baud that should be fine
 					 * otherwise upgrade your acoustic coupler to 56k ...
 					 */
@@ -60,7 +61,7 @@ const char *network_receive_file(const SOCKET src_sock, const char *const save_a
 					}
 				}
 				// ok, now here should be something new to read
-				int i = recv(src_sock, rbuf, length_read + 4096 < length ? 4096 : length - length_read, 0);
+				int i = recv(src_sock, rbuf, length_read + (sint32)sizeof(rbuf) < length ? (int)sizeof(rbuf) : length - length_read, 0);
 				if (i > 0) {
 					fwrite(rbuf, 1, i, f);
 					length_read += i;
@@ -99,6 +100,14 @@ const char *network_receive_file(const SOCKET src_sock, const char *const save_a
 #include "../world/simworld.h"
 #include "../utils/simstring.h"
 
+#include <signal.h>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+#ifdef MULTI_THREAD
+#include "../utils/simthread.h"
+#endif
+
 
 // connect to address (cp), receive gameinfo, close
 const char *network_gameinfo(const char *cp, gameinfo_t *gi)
@@ -270,54 +279,246 @@ end:
 }
 
 
-const char *network_send_file( const SOCKET dst_sock, const char *filename )
+/// state of the transfer of a game to a joining client, see network_send_file_start()
+static struct {
+	SOCKET sock;
+	FILE *fp;
+	uint32 length;
+	uint32 bytes_sent;
+	bool failed;
+	bool done;
+} file_transfer = { INVALID_SOCKET, NULL, 0, 0, false, true };
+
+/// shows the progress, when sending without a thread
+static loadingscreen_t *file_transfer_ls = NULL;
+
+#ifdef MULTI_THREAD
+static pthread_t file_transfer_thread;
+static bool file_transfer_thread_running = false;
+static pthread_mutex_t file_transfer_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+
+static void file_transfer_set_progress(uint32 bytes_sent, bool done, bool failed)
+{
+#ifdef MULTI_THREAD
+	pthread_mutex_lock( &file_transfer_mutex );
+#endif
+	file_transfer.bytes_sent = bytes_sent;
+	file_transfer.done = done;
+	file_transfer.failed = failed;
+#ifdef MULTI_THREAD
+	pthread_mutex_unlock( &file_transfer_mutex );
+#endif
+	if(  file_transfer_ls  ) {
+		file_transfer_ls->set_progress( bytes_sent );
+	}
+}
+
+
+// waits until the socket can take more data, false after 10s without progress
+static bool file_transfer_wait_for_socket()
+{
+	fd_set fds;
+	FD_ZERO(&fds);
+	FD_SET(file_transfer.sock,&fds);
+	struct timeval tv;
+	tv.tv_sec = 10;
+	tv.tv_usec = 0;
+	return select( FD_SETSIZE, NULL, &fds, NULL, &tv )==1;
+}
+
+
+// sends the whole file in large blocks
+static bool file_transfer_send_buffered(uint32 bytes_sent)
+{
+	static char buffer[65536];
+
+	fseek( file_transfer.fp, bytes_sent, SEEK_SET );
+	while(  bytes_sent < file_transfer.length  ) {
+		const int bytes_read = (int)fread( buffer, 1, sizeof(buffer), file_transfer.fp );
+		if(  bytes_read <= 0  ) {
+			return false;
+		}
+		int count = 0;
+		while(  count < bytes_read  ) {
+			const int sent = send( file_transfer.sock, buffer+count, bytes_read-count, 0 );
+			if(  sent == -1  &&  GET_LAST_ERROR() == EWOULDBLOCK  ) {
+				if(  !file_transfer_wait_for_socket()  ) {
+					return false;
+				}
+				continue;
+			}
+			if(  sent <= 0  ) {
+				return false;
+			}
+			count += sent;
+		}
+		bytes_sent += bytes_read;
+		file_transfer_set_progress( bytes_sent, false, false );
+	}
+	return true;
+}
+
+
+// sends the file to file_transfer.sock
+static bool file_transfer_send()
+{
+	uint32 bytes_sent = 0;
+#ifdef __linux__
+	// let the kernel copy the file to the socket
+	off_t offset = 0;
+	const int fd = fileno( file_transfer.fp );
+	while(  bytes_sent < file_transfer.length  ) {
+		const ssize_t sent = sendfile( file_transfer.sock, fd, &offset, file_transfer.length - bytes_sent );
+		if(  sent < 0  ) {
+			if(  errno == EAGAIN  ||  errno == EINTR  ) {
+				if(  !file_transfer_wait_for_socket()  ) {
+					return false;
+				}
+				continue;
+			}
+			if(  errno == EINVAL  ||  errno == ENOSYS  ) {
+				// not supported for this file or socket
+				break;
+			}
+			return false;
+		}
+		if(  sent == 0  ) {
+			return false;
+		}
+		bytes_sent += (uint32)sent;
+		file_transfer_set_progress( bytes_sent, false, false );
+	}
+#endif
+	return file_transfer_send_buffered( bytes_sent );
+}
+
+
+#ifdef MULTI_THREAD
+static void *file_transfer_thread_func(void *)
 {
+#if USE_WINSOCK == 0
+	// a client leaving during the transfer must not kill the server
+	sigset_t sigpipe;
+	sigemptyset( &sigpipe );
+	sigaddset( &sigpipe, SIGPIPE );
+	pthread_sigmask( SIG_BLOCK, &sigpipe, NULL );
+#endif
+	const bool ok = file_transfer_send();
+	file_transfer_set_progress( file_transfer.bytes_sent, true, !ok );
+	return NULL;
+}
+#endif
+
+
+const char *network_send_file_start( const SOCKET dst_sock, const char *filename )
+{
+	assert( file_transfer.done );
+
 	FILE *fp = dr_fopen(filename,"rb");
 	if (fp == NULL) {
-		dbg->warning("network_send_file", "could not open file %s", filename);
+		dbg->warning("network_send_file_start", "could not open file %s", filename);
 		return "Could not open file";
 	}
-	char buffer[1024];
 
 	// find out length
 	fseek(fp, 0, SEEK_END);
-	long length = (long)ftell(fp);
+	const long length = (long)ftell(fp);
 	rewind(fp);
-	uint32 bytes_sent = 0;
 
 	// send size of file
 	nwc_game_t nwc(length);
 	if (dst_sock==INVALID_SOCKET  ||  !nwc.send(dst_sock)) {
-		goto error;
+		fclose(fp);
+		return "Client closed connection during transfer";
 	}
 
-	// good place to show a progress bar
-	if(length>0) {
-		loadingscreen_t ls( translator::translate("Transferring game ..."), length, true, true );
-
-		while(  !feof(fp)  ) {
-			int bytes_read = (int)fread( buffer, 1, sizeof(buffer), fp );
-			uint16 dummy;
-			if( !network_send_data(dst_sock, buffer, bytes_read, dummy, 250) ) {
-				socket_list_t::remove_client(dst_sock);
-				goto error;
-			}
+	file_transfer.sock = dst_sock;
+	file_transfer.fp = fp;
+	file_transfer.length = length;
+	file_transfer_set_progress( 0, length<=0, false );
+
+#ifdef MULTI_THREAD
+	if(  length > 0  ) {
+		file_transfer_thread_running = pthread_create( &file_transfer_thread, NULL, file_transfer_thread_func, NULL ) == 0;
+		if(  !file_transfer_thread_running  ) {
+			// then send it during network_send_file_finish()
+			dbg->warning("network_send_file_start", "could not start sending thread");
+		}
+	}
+#endif
+	return NULL;
+}
+
+
+const char *network_send_file_finish()
+{
+	if(  file_transfer.fp == NULL  ) {
+		return NULL;
+	}
 
-			bytes_sent += bytes_read;
-			ls.set_progress( bytes_sent );
+#ifdef MULTI_THREAD
+	if(  file_transfer_thread_running  ) {
+		bool done;
+		uint32 bytes_sent;
+		pthread_mutex_lock( &file_transfer_mutex );
+		done = file_transfer.done;
+		bytes_sent = file_transfer.bytes_sent;
+		pthread_mutex_unlock( &file_transfer_mutex );
+
+		if(  !done  ) {
+			// still sending, show how much is left
+			loadingscreen_t ls( translator::translate("Transferring game ..."), file_transfer.length, true, true );
+			while(  !done  ) {
+				ls.set_progress( bytes_sent );
+				dr_sleep( 10 );
+				pthread_mutex_lock( &file_transfer_mutex );
+				done = file_transfer.done;
+				bytes_sent = file_transfer.bytes_sent;
+				pthread_mutex_unlock( &file_transfer_mutex );
+			}
 		}
+		pthread_join( file_transfer_thread, NULL );
+		file_transfer_thread_running = false;
 	}
+#endif
+	if(  !file_transfer.done  ) {
+		// no thread: send it now
+#if USE_WINSOCK == 0
+		signal(SIGPIPE, SIG_IGN);
+#endif
+		loadingscreen_t ls( translator::translate("Transferring game ..."), file_transfer.length, true, true );
+		file_transfer_ls = &ls;
+		const bool ok = file_transfer_send();
+		file_transfer_ls = NULL;
+		file_transfer_set_progress( file_transfer.bytes_sent, true, !ok );
+#if USE_WINSOCK == 0
+		signal(SIGPIPE, SIG_DFL);
+#endif
+	}
+
+	fclose( file_transfer.fp );
+	file_transfer.fp = NULL;
 
+	if(  file_transfer.failed  ) {
+		socket_list_t::remove_client( file_transfer.sock );
+		return "Client closed connection during transfer";
+	}
 	// ok, new client has savegame
-	fclose(fp);
 	return NULL;
+}
+
 
-error:
-	// an error occurred: close file
-	fclose(fp);
-	return "Client closed connection during transfer";
+const char *network_send_file( const SOCKET dst_sock, const char *filename )
+{
+	if(  const char *err = network_send_file_start( dst_sock, filename )  ) {
+		return err;
+	}
+	return network_send_file_finish();
 }
 
+
 /// POST a message (poststr) to an HTTP server at the specified address and relative path (name)
 /// Optionally: Receive response to file localname
 const char *network_http_post( const char *address, const char *name, const char *poststr, const char *localname )
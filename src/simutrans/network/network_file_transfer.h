@@ -27,6 +27,16 @@ const char *network_connect(const char *cp, karte_t *world);
 /// Send file over network
 const char *network_send_file(const SOCKET dst_sock, const char *filename);
 
+/**
+ * Starts sending a file over network in the background (when compiled with MULTI_THREAD),
+ * so the caller can do something else meanwhile.
+ * Only one transfer at a time. Nothing else may be sent to @p dst_sock before network_send_file_finish().
+ */
+const char *network_send_file_start(const SOCKET dst_sock, const char *filename);
+
+/// Waits until the file of network_send_file_start() is sent; on error the client is removed
+const char *network_send_file_finish();
+
 /// Receive file (directly to disk)
 const char *network_receive_file(const SOCKET src_sock, const char *const save_as, const sint32 length, const sint32 timeout=10000);
 
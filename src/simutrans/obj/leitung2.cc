@@ -102,7 +102,7 @@ fabrik_t *leitung_t::suche_fab_4(const koord pos)
 leitung_t::leitung_t(loadsave_t *file) : obj_t()
 {
 	image = IMG_EMPTY;
-	set_net(NULL);
+	net = NULL;
 	ribi = ribi_t::none;
 	is_transformer = false;
 	rdwr(file);
@@ -112,7 +112,7 @@ leitung_t::leitung_t(loadsave_t *file) : obj_t()
 leitung_t::leitung_t(koord3d pos, player_t *player) : obj_t(pos)
 {
 	image = IMG_EMPTY;
-	set_net(NULL);
+	net = NULL;
 	set_owner( player );
 	set_desc(way_builder_t::leitung_desc);
 	is_transformer = false;
@@ -133,14 +133,13 @@ leitung_t::~leitung_t()
 		set_flag( obj_t::not_on_map );
 
 		if(neighbours>1) {
-			// only reconnect if two connections ...
+			// the net may fall apart: all parts not connected to the first neighbour get a new net
+			powernet_t *const old_net = get_net();
 			bool first = true;
 			for(int i=0; i<4; i++) {
 				if(conn[i]!=NULL) {
-					if(!first) {
-						// replace both nets
-						powernet_t *new_net = new powernet_t();
-						conn[i]->replace(new_net);
+					if(!first  &&  conn[i]->get_net()==old_net) {
+						conn[i]->replace( new powernet_t() );
 					}
 					first = false;
 				}
@@ -154,11 +153,10 @@ leitung_t::~leitung_t()
 			}
 		}
 
-		if(neighbours==0) {
-			delete net;
-		}
 		player_t::add_maintenance(get_owner(), -get_maintenance(), powerline_wt);
 	}
+	// frees the net, if this was the last powerline
+	set_net(NULL);
 }
 
 
@@ -185,23 +183,46 @@ void leitung_t::rotate90()
  */
 void leitung_t::replace(powernet_t* new_net)
 {
-	if (get_net() != new_net) {
-		// convert myself ...
-//DBG_MESSAGE("leitung_t::replace()","My net %p by %p at (%i,%i)",new_net,current,base_pos.x,base_pos.y);
-		set_net(new_net);
-	}
+	// not recursive, long lines would need a very deep stack
+	vector_tpl<leitung_t *> todo;
+	todo.append( this );
+	while(  !todo.empty()  ) {
+		leitung_t *const lt = todo.pop_back();
+		if(  lt->get_net() == new_net  ) {
+			continue;
+		}
+		lt->set_net(new_net);
 
-	leitung_t * conn[4];
-	if(gimme_neighbours(conn)>0) {
-		for(int i=0; i<4; i++) {
-			if(conn[i] && conn[i]->get_net()!=new_net) {
-				conn[i]->replace(new_net);
+		leitung_t * conn[4];
+		if(lt->gimme_neighbours(conn)>0) {
+			for(int i=0; i<4; i++) {
+				if(conn[i] && conn[i]->get_net()!=new_net) {
+					todo.append( conn[i] );
+				}
 			}
 		}
 	}
 }
 
 
+powernet_t *leitung_t::get_net() const
+{
+	return net ? net->get_root() : NULL;
+}
+
+
+void leitung_t::set_net(powernet_t *p)
+{
+	if(  p  ) {
+		p->attach();
+	}
+	if(  net  ) {
+		net->detach();
+	}
+	net = p;
+}
+
+
 /**
  * Connect this piece of powerline to its neighbours
  * -> this can merge power networks
@@ -210,39 +231,20 @@ void leitung_t::verbinde()
 {
 	// first get my own ...
 	powernet_t *new_net = get_net();
-//DBG_MESSAGE("leitung_t::verbinde()","Searching net at (%i,%i)",get_pos().x,get_pos().x);
 	leitung_t * conn[4];
 	if(gimme_neighbours(conn)>0) {
-		for( uint8 i=0;  i<4 && new_net==NULL;  i++  ) {
-			if(conn[i]) {
-				new_net = conn[i]->get_net();
+		// ... and merge all neighbouring nets into it
+		for( uint8 i=0;  i<4;  i++  ) {
+			if(conn[i]  &&  conn[i]->get_net()) {
+				new_net = new_net ? powernet_t::merge( new_net, conn[i]->get_net() ) : conn[i]->get_net();
 			}
 		}
 	}
 
-//DBG_MESSAGE("leitung_t::verbinde()","Found net %p",new_net);
-
 	// we are alone?
 	if(get_net()==NULL) {
-		if(new_net!=NULL) {
-			replace(new_net);
-		}
-		else {
-			// then we start a new net
-			set_net(new powernet_t());
-//DBG_MESSAGE("leitung_t::verbinde()","Creating new net %p",new_net);
-		}
-	}
-	else if(new_net) {
-		powernet_t *my_net = get_net();
-		for( uint8 i=0;  i<4;  i++  ) {
-			if(conn[i] && conn[i]->get_net()!=new_net) {
-				conn[i]->replace(new_net);
-			}
-		}
-		if(my_net && my_net!=new_net) {
-			delete my_net;
-		}
+		// then we start a new net
+		set_net( new_net ? new_net : new powernet_t() );
 	}
 }
 
@@ -349,10 +351,11 @@ void leitung_t::finish_rd()
 #ifdef MULTI_THREAD
 	pthread_mutex_lock( &verbinde_mutex );
 	verbinde();
-	pthread_mutex_unlock( &verbinde_mutex );
+	// calc_neighbourhood() compares nets, so other threads must not merge them meanwhile
 	pthread_mutex_lock( &calc_image_mutex );
 	calc_neighbourhood();
 	pthread_mutex_unlock( &calc_image_mutex );
+	pthread_mutex_unlock( &verbinde_mutex );
 #else
 	verbinde();
 	calc_neighbourhood();
@@ -468,7 +471,7 @@ pumpe_t::~pumpe_t()
 		fab = NULL;
 	}
 	if(  net != NULL  ) {
-		net->sub_supply(power_supply);
+		get_net()->sub_supply(power_supply);
 	}
 }
 
@@ -507,7 +510,7 @@ void pumpe_t::set_net(powernet_t * p)
 	leitung_t::set_net(p);
 
 	if(  p != NULL  ) {
-		p->add_supply(power_supply);
+		p->get_root()->add_supply(power_supply);
 	}
 }
 
@@ -546,7 +549,7 @@ void pumpe_t::finish_rd()
 {
 	leitung_t::finish_rd();
 
-	assert(get_net());
+	assert(net);
 
 	if(  fab==NULL  ) {
 		if(welt->lookup(get_pos())->ist_karten_boden()) {
@@ -658,7 +661,7 @@ senke_t::~senke_t()
 		fab = NULL;
 	}
 	if(  net != NULL  ) {
-		net->sub_demand(power_demand);
+		get_net()->sub_demand(power_demand);
 	}
 }
 
@@ -691,7 +694,7 @@ void senke_t::set_net(powernet_t * p)
 	leitung_t::set_net(p);
 
 	if(  p != NULL  ) {
-		p->add_demand(power_demand);
+		p->get_root()->add_demand(power_demand);
 	}
 }
 
@@ -808,7 +811,7 @@ void senke_t::finish_rd()
 {
 	leitung_t::finish_rd();
 
-	assert(get_net());
+	assert(net);
 
 	if(  fab==NULL  ) {
 		if(welt->lookup(get_pos())->ist_karten_boden()) {
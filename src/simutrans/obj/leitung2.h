@@ -37,7 +37,7 @@ protected:
 	ribi_t::ribi ribi:4;
 
 	/**
-	* We are part of this network
+	* We are part of this network (or of the one it was merged into)
 	*/
 	powernet_t * net;
 
@@ -49,6 +49,7 @@ protected:
 	*/
 	void verbinde();
 
+	/// gives the whole connected network the new net
 	void replace(powernet_t* neu);
 
 	void add_ribi(ribi_t::ribi r) { ribi |= r; }
@@ -62,12 +63,12 @@ public:
 	// number of fractional bits for network load values
 	static const uint8 FRACTION_PRECISION;
 
-	powernet_t* get_net() const { return net; }
+	powernet_t* get_net() const;
 	/**
 	 * Changes the currently registered power net.
 	 * Can be overwritten to modify the power net on change.
 	 */
-	virtual void set_net(powernet_t* p) { net = p; }
+	virtual void set_net(powernet_t* p);
 
 	const way_desc_t * get_desc() { return desc; }
 	void set_desc(const way_desc_t *new_desc) { desc = new_desc; }
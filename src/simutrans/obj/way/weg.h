@@ -279,7 +279,13 @@ public:
 	 */
 	void clear_sign_flag() { flags &= ~(HAS_SIGN | HAS_SIGNAL); }
 
-	inline void set_image( image_id b ) { image = b; }
+	/// also marks the way dirty, since it is drawn with the ground (see main_view_t::display_region)
+	inline void set_image( image_id b ) {
+		if(  image != b  ) {
+			image = b;
+			set_flag(obj_t::dirty);
+		}
+	}
 	image_id get_image() const OVERRIDE {return image;}
 
 	inline void set_foreground_image( image_id b ) { foreground_image = b; }
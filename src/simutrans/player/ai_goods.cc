@@ -56,7 +56,12 @@ ai_goods_t::ai_goods_t(uint8 nr) :
 	count_rail(0),
 	count_road(0),
 	count(0),
-	next_construction_steps(welt->get_steps()+50)
+	next_construction_steps(welt->get_steps()+50),
+	plan_requested(false),
+	plan_ready(false),
+	plan_rail_length(0),
+	planned_state(NR_INIT),
+	planned_road(false)
 {
 	road_transport = nr!=7;
 	rail_transport = nr>2;
@@ -240,6 +245,18 @@ bool ai_goods_t::suche_platz1_platz2(fabrik_t *qfab, fabrik_t *zfab, int length
 	clean_marker(platz1,size1);
 	clean_marker(platz2,size2);
 
+	const bool ok = find_platz1_platz2( qfab, zfab, length );
+	if(  ok  ) {
+		// reserve space with marker
+		set_marker( platz1, size1 );
+		set_marker( platz2, size2 );
+	}
+	return ok;
+}
+
+
+bool ai_goods_t::find_platz1_platz2(fabrik_t *qfab, fabrik_t *zfab, int length )
+{
 	koord start( qfab->get_pos().get_2d() );
 	koord start_size( length, 0 );
 	koord ziel( zfab->get_pos().get_2d() );
@@ -298,6 +315,7 @@ bool ai_goods_t::suche_platz1_platz2(fabrik_t *qfab, fabrik_t *zfab, int length
 			bauigel.set_keep_existing_faster_ways(true);
 			bauigel.set_keep_city_roads(true);
 			bauigel.set_maximum(10000);
+			bauigel.set_search_context(&search_context);
 			bauigel.calc_route(tile_list[0], tile_list[1]);
 			if(  bauigel.get_count() > 2  ) {
 				// Sometimes reverse route is the best, so we have to change the koords.
@@ -339,15 +357,35 @@ bool ai_goods_t::suche_platz1_platz2(fabrik_t *qfab, fabrik_t *zfab, int length
 		size2 = ziel_size;
 
 		DBG_MESSAGE( "ai_t::suche_platz1_platz2()", "platz1=%d,%d platz2=%d,%d", platz1.x, platz1.y, platz2.x, platz2.y );
-
-		// reserve space with marker
-		set_marker( platz1, size1 );
-		set_marker( platz2, size2 );
 	}
 	return ok;
 }
 
 
+bool ai_goods_t::is_platz_free(koord place, koord size) const
+{
+	// same area as set_marker()
+	koord pos;
+	if(size.y<0) {
+		place.y += size.y;
+		size.y = -size.y;
+	}
+	if(size.x<0) {
+		place.x += size.x;
+		size.x = -size.x;
+	}
+	for(  pos.y=place.y;  pos.y<=place.y+size.y;  pos.y++  ) {
+		for(  pos.x=place.x;  pos.x<=place.x+size.x;  pos.x++  ) {
+			const grund_t *gr = welt->lookup_kartenboden(pos);
+			if(  gr==NULL  ||  gr->is_halt()  ||  !gr->ist_natur()  ||  gr->kann_alle_obj_entfernen(this)!=NULL  ) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+
 
 /**
  * build docks and ships
@@ -764,9 +802,40 @@ DBG_MESSAGE("ai_goods_t::create_simple_rail_transport()","building simple track
 
 
 
+bool ai_goods_t::wants_to_plan() const
+{
+	// not worth it, if step() does not reach NR_BAUE_ROUTE1 anyway
+	return active  &&  plan_requested  &&  state==NR_BAUE_ROUTE1  &&  welt->get_steps() >= next_construction_steps;
+}
+
+
+/* searches the stops for the vehicles chosen by step() in NR_BAUE_ROUTE1:
+ * first for the train if it was cheaper, then for the road vehicles
+ */
+void ai_goods_t::plan()
+{
+	planned_state = NR_BAUE_ROUTE1;
+	planned_road = false;
+	if(  plan_rail_length>0  &&  find_platz1_platz2(start, ziel, plan_rail_length)  ) {
+		planned_state = ship_vehicle ? NR_BAUE_WATER_ROUTE : NR_BAUE_SIMPLE_SCHIENEN_ROUTE;
+	}
+	// if state is still NR_BAUE_ROUTE1 then there are no suitable places
+	else if(  count_road != 255  &&  find_platz1_platz2(start, ziel, 0)  ) {
+		// rail was too expensive or not successful
+		planned_state = ship_vehicle ? NR_BAUE_WATER_ROUTE : NR_BAUE_STRASSEN_ROUTE;
+		planned_road = true;
+	}
+	plan_ready = true;
+}
+
+
 // the normal length procedure for freight AI
 void ai_goods_t::step()
 {
+	// a plan is only valid for the step it was made for
+	const bool planned = plan_ready;
+	plan_ready = false;
+
 	// needed for schedule of stops ...
 	player_t::step();
 
@@ -822,6 +891,7 @@ void ai_goods_t::step()
 				if(  start->get_desc()->get_placement()!=factory_desc_t::Water  ||  vehicle_search( water_wt, 0, 10, freight, false)!=NULL  ) {
 					DBG_MESSAGE("ai_goods_t::do_ki", "Consider route from %s (%i,%i) to %s (%i,%i)", start->get_name(), start->get_pos().x, start->get_pos().y, ziel->get_name(), ziel->get_pos().x, ziel->get_pos().y );
 					state = NR_BAUE_ROUTE1;
+					plan_requested = false;
 				}
 				else {
 					// add to impossible connections
@@ -838,178 +908,194 @@ void ai_goods_t::step()
 
 		// now we need so select the cheapest mean to get maximum profit
 		case NR_BAUE_ROUTE1:
-		{
-			/* if we reached here, we decide to built a route;
-			 * the KI just chooses the way to run the operation at maximum profit (minimum loss).
-			 * The KI will built also a loosing route; this might be required by future versions to
-			 * be able to built a network!
-			 */
-
-			/* for the calculation we need:
-			 * a suitable car (and engine)
-			 * a suitable way
-			 */
-			uint32 dist = koord_distance( start->get_pos(), ziel->get_pos() );
-
-			// guess the "optimum" speed (usually a little too low)
-			sint32 best_rail_speed = 80;// is ok enough for goods, was: min(60+freight->get_speed_bonus()*5, 140 );
-			sint32 best_road_speed = min(60+freight->get_speed_bonus()*5, 130 );
-
-			INT_CHECK("simplay 1265");
-
-			// is rail transport allowed?
-			if(rail_transport) {
-				// any rail car that transport this good (actually this weg_t the largest)
-				rail_vehicle = vehicle_search( track_wt, 0, best_rail_speed,  freight, true);
+			if(  plan_requested  ) {
+				plan_requested = false;
+				// the players stepping before may have built on the planned places
+				if(  !planned  ||  (planned_state!=NR_BAUE_ROUTE1  &&  !(is_platz_free(platz1, size1)  &&  is_platz_free(platz2, size2)))  ) {
+					plan();
+					plan_ready = false;
+				}
+				state = planned_state;
+				if(  state!=NR_BAUE_ROUTE1  ) {
+					if(  planned_road  ) {
+						count_rail = 255;
+					}
+					next_construction_steps += 10;
+					// reserve space with marker
+					set_marker( platz1, size1 );
+					set_marker( platz2, size2 );
+				}
+				else {
+					// no success at all: maybe this route is not builtable ... add to forbidden connections
+					forbidden_connections.append( new fabconnection_t( start, ziel, freight ) );
+					ziel = NULL; // otherwise it may always try to built the same route!
+					state = CHECK_CONVOI;
+				}
 			}
-			rail_engine = NULL;
-			rail_weg = NULL;
+			else {
+				/* if we reached here, we decide to built a route;
+				 * the KI just chooses the way to run the operation at maximum profit (minimum loss).
+				 * The KI will built also a loosing route; this might be required by future versions to
+				 * be able to built a network!
+				 */
+
+				/* for the calculation we need:
+				 * a suitable car (and engine)
+				 * a suitable way
+				 */
+				uint32 dist = koord_distance( start->get_pos(), ziel->get_pos() );
+
+				// guess the "optimum" speed (usually a little too low)
+				sint32 best_rail_speed = 80;// is ok enough for goods, was: min(60+freight->get_speed_bonus()*5, 140 );
+				sint32 best_road_speed = min(60+freight->get_speed_bonus()*5, 130 );
+
+				INT_CHECK("simplay 1265");
+
+				// is rail transport allowed?
+				if(rail_transport) {
+					// any rail car that transport this good (actually this weg_t the largest)
+					rail_vehicle = vehicle_search( track_wt, 0, best_rail_speed,  freight, true);
+				}
+				rail_engine = NULL;
+				rail_weg = NULL;
 DBG_MESSAGE("do_ki()","rail vehicle %p",rail_vehicle);
 
-			// is road transport allowed?
-			if(road_transport) {
-				// any road car that transport this good (actually this returns the largest)
-				road_vehicle = vehicle_search( road_wt, 10, best_road_speed, freight, false);
-			}
-			road_weg = NULL;
+				// is road transport allowed?
+				if(road_transport) {
+					// any road car that transport this good (actually this returns the largest)
+					road_vehicle = vehicle_search( road_wt, 10, best_road_speed, freight, false);
+				}
+				road_weg = NULL;
 DBG_MESSAGE("do_ki()","road vehicle %p",road_vehicle);
 
-			ship_vehicle = NULL;
-			if(start->get_desc()->get_placement()==factory_desc_t::Water) {
-				// largest ship available
-				ship_vehicle = vehicle_search( water_wt, 0, 20, freight, false);
-			}
+				ship_vehicle = NULL;
+				if(start->get_desc()->get_placement()==factory_desc_t::Water) {
+					// largest ship available
+					ship_vehicle = vehicle_search( water_wt, 0, 20, freight, false);
+				}
 
-			INT_CHECK("simplay 1265");
+				INT_CHECK("simplay 1265");
 
 
-			// properly calculate production
-			const array_tpl<ware_production_t>& output = start->get_output();
-			uint start_ware=0;
-			while(  start_ware<output.get_count()  &&  output[start_ware].get_typ()!=freight  ) {
-				start_ware++;
-			}
-			assert(  start_ware<output.get_count()  );
-			const int prod = min((uint32)ziel->get_base_production(),
-			                 ( start->get_base_production() * start->get_desc()->get_product(start_ware)->get_factor() )/256u - (uint32)(start->get_output()[start_ware].get_stat(1, FAB_GOODS_DELIVERED)) );
+				// properly calculate production
+				const array_tpl<ware_production_t>& output = start->get_output();
+				uint start_ware=0;
+				while(  start_ware<output.get_count()  &&  output[start_ware].get_typ()!=freight  ) {
+					start_ware++;
+				}
+				assert(  start_ware<output.get_count()  );
+				const int prod = min((uint32)ziel->get_base_production(),
+				                 ( start->get_base_production() * start->get_desc()->get_product(start_ware)->get_factor() )/256u - (uint32)(start->get_output()[start_ware].get_stat(1, FAB_GOODS_DELIVERED)) );
 
 DBG_MESSAGE("do_ki()","check railway");
-			/* calculate number of cars for railroad */
-			count_rail=255; // no cars yet
-			if(  rail_vehicle!=NULL  ) {
-				// if our car is faster: well use slower speed to save money
-				best_rail_speed = min(51, rail_vehicle->get_topspeed());
-				// for engine: guess number of cars
-				count_rail = (prod*dist) / (rail_vehicle->get_capacity()*best_rail_speed)+1;
-				// assume the engine weight 100 tons for power needed calculation
-				int total_weight = count_rail*( rail_vehicle->get_capacity()*freight->get_weight_per_unit() + rail_vehicle->get_weight() );
+				/* calculate number of cars for railroad */
+				count_rail=255; // no cars yet
+				if(  rail_vehicle!=NULL  ) {
+					// if our car is faster: well use slower speed to save money
+					best_rail_speed = min(51, rail_vehicle->get_topspeed());
+					// for engine: guess number of cars
+					count_rail = (prod*dist) / (rail_vehicle->get_capacity()*best_rail_speed)+1;
+					// assume the engine weight 100 tons for power needed calculation
+					int total_weight = count_rail*( rail_vehicle->get_capacity()*freight->get_weight_per_unit() + rail_vehicle->get_weight() );
 //				long power_needed = (long)(((best_rail_speed*best_rail_speed)/2500.0+1.0)*(100.0+count_rail*(rail_vehicle->get_weight()+rail_vehicle->get_capacity()*freight->get_weight_per_unit()*0.001)));
-				rail_engine = vehicle_search( track_wt, total_weight/1000, best_rail_speed, NULL, wayobj_t::default_oberleitung!=NULL);
-				if(  rail_engine!=NULL  ) {
-					best_rail_speed = min(rail_engine->get_topspeed(),rail_vehicle->get_topspeed());
-					// find cheapest track with that speed (and no monorail/elevated/tram tracks, please)
-					rail_weg = way_builder_t::weg_search( track_wt, best_rail_speed, welt->get_timeline_year_month(),type_flat );
-					if(  rail_weg!=NULL  ) {
-						if(  best_rail_speed>rail_weg->get_topspeed()  ) {
-							best_rail_speed = rail_weg->get_topspeed();
-						}
-						// no train can have more than 15 cars
-						count_rail = min( 22, (3*prod*dist) / (rail_vehicle->get_capacity()*best_rail_speed*2) );
-						// if engine too week, reduce number of cars
-						if(  count_rail*80*64>(int)(rail_engine->get_power()*rail_engine->get_gear())  ) {
-							count_rail = rail_engine->get_power()*rail_engine->get_gear()/(80*64);
-						}
-						count_rail = ((count_rail+1)&0x0FE)+1;
+					rail_engine = vehicle_search( track_wt, total_weight/1000, best_rail_speed, NULL, wayobj_t::default_oberleitung!=NULL);
+					if(  rail_engine!=NULL  ) {
+						best_rail_speed = min(rail_engine->get_topspeed(),rail_vehicle->get_topspeed());
+						// find cheapest track with that speed (and no monorail/elevated/tram tracks, please)
+						rail_weg = way_builder_t::weg_search( track_wt, best_rail_speed, welt->get_timeline_year_month(),type_flat );
+						if(  rail_weg!=NULL  ) {
+							if(  best_rail_speed>rail_weg->get_topspeed()  ) {
+								best_rail_speed = rail_weg->get_topspeed();
+							}
+							// no train can have more than 15 cars
+							count_rail = min( 22, (3*prod*dist) / (rail_vehicle->get_capacity()*best_rail_speed*2) );
+							// if engine too week, reduce number of cars
+							if(  count_rail*80*64>(int)(rail_engine->get_power()*rail_engine->get_gear())  ) {
+								count_rail = rail_engine->get_power()*rail_engine->get_gear()/(80*64);
+							}
+							count_rail = ((count_rail+1)&0x0FE)+1;
 DBG_MESSAGE("ai_goods_t::do_ki()","Engine %s guess to need %d rail cars %s for route (%s)", rail_engine->get_name(), count_rail, rail_vehicle->get_name(), rail_weg->get_name() );
+						}
 					}
-				}
-				if(  rail_engine==NULL  ||  rail_weg==NULL  ) {
-					// no rail transport possible
+					if(  rail_engine==NULL  ||  rail_weg==NULL  ) {
+						// no rail transport possible
 DBG_MESSAGE("ai_goods_t::do_ki()","No railway possible.");
-					rail_vehicle = NULL;
-					count_rail = 255;
+						rail_vehicle = NULL;
+						count_rail = 255;
+					}
 				}
-			}
 
-			INT_CHECK("simplay 1265");
+				INT_CHECK("simplay 1265");
 
 DBG_MESSAGE("do_ki()","check railway");
-			/* calculate number of cars for road; much easier */
-			count_road=255; // no cars yet
-			if(  road_vehicle!=NULL  ) {
-				best_road_speed = road_vehicle->get_topspeed();
-				// find cheapest road
-				road_weg = way_builder_t::weg_search( road_wt, best_road_speed, welt->get_timeline_year_month(),type_flat );
-				if(  road_weg!=NULL  ) {
-					if(  best_road_speed>road_weg->get_topspeed()  ) {
-						best_road_speed = road_weg->get_topspeed();
-					}
-					// minimum vehicle is 1, maximum vehicle is 48, more just result in congestion
-					count_road = min( 254, (prod*dist) / (road_vehicle->get_capacity()*best_road_speed*2)+2 );
+				/* calculate number of cars for road; much easier */
+				count_road=255; // no cars yet
+				if(  road_vehicle!=NULL  ) {
+					best_road_speed = road_vehicle->get_topspeed();
+					// find cheapest road
+					road_weg = way_builder_t::weg_search( road_wt, best_road_speed, welt->get_timeline_year_month(),type_flat );
+					if(  road_weg!=NULL  ) {
+						if(  best_road_speed>road_weg->get_topspeed()  ) {
+							best_road_speed = road_weg->get_topspeed();
+						}
+						// minimum vehicle is 1, maximum vehicle is 48, more just result in congestion
+						count_road = min( 254, (prod*dist) / (road_vehicle->get_capacity()*best_road_speed*2)+2 );
 DBG_MESSAGE("ai_goods_t::do_ki()","guess to need %d road cars %s for route %s", count_road, road_vehicle->get_name(), road_weg->get_name() );
-				}
-				else {
-					// no roads there !?!
+					}
+					else {
+						// no roads there !?!
 DBG_MESSAGE("ai_goods_t::do_ki()","No roadway possible.");
+					}
 				}
-			}
 
-			// find the cheapest transport ...
-			// assume maximum cost
-			int cost_rail=0x7FFFFFFF, cost_road=0x7FFFFFFF;
-			int income_rail=0, income_road=0;
-
-			// calculate cost for rail
-			if(  count_rail<255  ) {
-				int freight_price = (freight->get_value()*rail_vehicle->get_capacity()*count_rail)/24*((8000+(best_rail_speed-80)*freight->get_speed_bonus())/1000);
-				// calculated here, since the above number was based on production
-				// only uneven number of cars bigger than 3 makes sense ...
-				count_rail = max( 3, count_rail );
-				income_rail = (freight_price*best_rail_speed)/(2*dist+count_rail);
-				cost_rail = rail_weg->get_maintenance() + (((count_rail+1)/2)*300)/dist + ((count_rail*rail_vehicle->get_running_cost()+rail_engine->get_running_cost())*best_rail_speed)/(2*dist+count_rail);
-				DBG_MESSAGE("ai_goods_t::do_ki()","Netto credits per day for rail transport %.2f (income %.2f)",cost_rail/100.0, income_rail/100.0 );
-				cost_rail -= income_rail;
-			}
+				// find the cheapest transport ...
+				// assume maximum cost
+				int cost_rail=0x7FFFFFFF, cost_road=0x7FFFFFFF;
+				int income_rail=0, income_road=0;
+
+				// calculate cost for rail
+				if(  count_rail<255  ) {
+					int freight_price = (freight->get_value()*rail_vehicle->get_capacity()*count_rail)/24*((8000+(best_rail_speed-80)*freight->get_speed_bonus())/1000);
+					// calculated here, since the above number was based on production
+					// only uneven number of cars bigger than 3 makes sense ...
+					count_rail = max( 3, count_rail );
+					income_rail = (freight_price*best_rail_speed)/(2*dist+count_rail);
+					cost_rail = rail_weg->get_maintenance() + (((count_rail+1)/2)*300)/dist + ((count_rail*rail_vehicle->get_running_cost()+rail_engine->get_running_cost())*best_rail_speed)/(2*dist+count_rail);
+					DBG_MESSAGE("ai_goods_t::do_ki()","Netto credits per day for rail transport %.2f (income %.2f)",cost_rail/100.0, income_rail/100.0 );
+					cost_rail -= income_rail;
+				}
 
-			// and calculate cost for road
-			if(  count_road<255  ) {
-				// for short distance: reduce number of cars
-				// calculated here, since the above number was based on production
-				count_road = clamp( (sint32)(dist*15)/best_road_speed, 2, count_road );
-				int freight_price = (freight->get_value()*road_vehicle->get_capacity()*count_road)/24*((8000+(best_road_speed-80)*freight->get_speed_bonus())/1000);
-				cost_road = road_weg->get_maintenance() + 300/dist + (count_road*road_vehicle->get_running_cost()*best_road_speed)/(2*dist+5);
-				income_road = (freight_price*best_road_speed)/(2*dist+5);
-				DBG_MESSAGE("ai_goods_t::do_ki()","Netto credits per day and km for road transport %.2f (income %.2f)",cost_road/100.0, income_road/100.0 );
-				cost_road -= income_road;
-			}
+				// and calculate cost for road
+				if(  count_road<255  ) {
+					// for short distance: reduce number of cars
+					// calculated here, since the above number was based on production
+					count_road = clamp( (sint32)(dist*15)/best_road_speed, 2, count_road );
+					int freight_price = (freight->get_value()*road_vehicle->get_capacity()*count_road)/24*((8000+(best_road_speed-80)*freight->get_speed_bonus())/1000);
+					cost_road = road_weg->get_maintenance() + 300/dist + (count_road*road_vehicle->get_running_cost()*best_road_speed)/(2*dist+5);
+					income_road = (freight_price*best_road_speed)/(2*dist+5);
+					DBG_MESSAGE("ai_goods_t::do_ki()","Netto credits per day and km for road transport %.2f (income %.2f)",cost_road/100.0, income_road/100.0 );
+					cost_road -= income_road;
+				}
 
-			// check location, if vehicles found
-			if(  min(count_road,count_rail)!=255  ) {
-				// road or rail?
-				int length = 1;
-				if(  cost_rail<cost_road  ) {
-					length = (rail_engine->get_length() + count_rail*rail_vehicle->get_length()+CARUNITS_PER_TILE-1)/CARUNITS_PER_TILE;
-					if(suche_platz1_platz2(start, ziel, length)) {
-						state = ship_vehicle ? NR_BAUE_WATER_ROUTE : NR_BAUE_SIMPLE_SCHIENEN_ROUTE;
-						next_construction_steps += 10;
+				// check location, if vehicles found
+				if(  min(count_road,count_rail)!=255  ) {
+					// road or rail?
+					plan_rail_length = 0;
+					if(  cost_rail<cost_road  ) {
+						plan_rail_length = (rail_engine->get_length() + count_rail*rail_vehicle->get_length()+CARUNITS_PER_TILE-1)/CARUNITS_PER_TILE;
 					}
+					// the places are searched by plan() before the next step, which may run outside the main thread
+					clean_marker(platz1,size1);
+					clean_marker(platz2,size2);
+					plan_requested = true;
 				}
-				// if state is still NR_BAUE_ROUTE1 then there are no suitable places
-				if(state==NR_BAUE_ROUTE1  &&  (count_road != 255)  &&  suche_platz1_platz2(start, ziel, 0)) {
-					// rail was too expensive or not successful
-					count_rail = 255;
-					state = ship_vehicle ? NR_BAUE_WATER_ROUTE : NR_BAUE_STRASSEN_ROUTE;
-					next_construction_steps += 10;
+				else {
+					// maybe this route is not builtable ... add to forbidden connections
+					forbidden_connections.append( new fabconnection_t( start, ziel, freight ) );
+					ziel = NULL; // otherwise it may always try to built the same route!
+					state = CHECK_CONVOI;
 				}
 			}
-			// no success at all?
-			if(state==NR_BAUE_ROUTE1) {
-				// maybe this route is not builtable ... add to forbidden connections
-				forbidden_connections.append( new fabconnection_t( start, ziel, freight ) );
-				ziel = NULL; // otherwise it may always try to built the same route!
-				state = CHECK_CONVOI;
-			}
-		}
 		break;
 
 		// built a simple ship route
@@ -8,6 +8,7 @@
 
 
 #include "ai.h"
+#include "../builder/wegbauer.h"
 
 
 /// Simple goods transport AI
@@ -64,6 +65,18 @@ private:
 	/* start and end stop position (and their size) */
 	koord platz1, size1, platz2, size2, harbour;
 
+	/* the stops of NR_BAUE_ROUTE1 are searched by plan() before the step after the vehicles were chosen;
+	 * not saved, after loading the vehicles are chosen again
+	 */
+	bool plan_requested;
+	bool plan_ready;           // plan() ran before this step
+	sint32 plan_rail_length;   // length of the train stops to try first, 0 for road only
+	enum state planned_state;  // still NR_BAUE_ROUTE1 if no places were found
+	bool planned_road;         // the places are for road vehicles
+
+	// own memory for the route test, since AIs may plan at the same time
+	way_search_context_t search_context;
+
 	// KI helper class
 	class fabconnection_t{
 		friend class ai_goods_t;
@@ -96,8 +109,15 @@ private:
 	 */
 	int get_factory_tree_missing_count( fabrik_t *fab );
 
+	// finds places for the stops, without reserving them
+	bool find_platz1_platz2(fabrik_t *qfab, fabrik_t *zfab, int length);
+
+	// finds places for the stops and reserves them with markers
 	bool suche_platz1_platz2(fabrik_t *qfab, fabrik_t *zfab, int length);
 
+	// true, if nothing was built on these places since they were found
+	bool is_platz_free(koord place, koord size) const;
+
 	int baue_bahnhof(const koord* p, int vehicle_count);
 
 	bool create_simple_rail_transport();
@@ -124,6 +144,10 @@ public:
 
 	void step() OVERRIDE;
 
+	bool wants_to_plan() const OVERRIDE;
+
+	void plan() OVERRIDE;
+
 	void new_year() OVERRIDE;
 
 	void rotate90( const sint16 y_size ) OVERRIDE;
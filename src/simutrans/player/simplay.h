@@ -296,6 +296,21 @@ public:
 	 */
 	virtual void step();
 
+	/**
+	 * True, if plan() has to be called before the next step().
+	 */
+	virtual bool wants_to_plan() const { return false; }
+
+	/**
+	 * Searches for a construction site that the next step() builds on.
+	 * Called by simworld.cc for all planning players before any of them steps,
+	 * several players at once on worker threads. Hence it must only read the world,
+	 * must not call simrand() and must not use memory shared with other players
+	 * (like the default way builder search context). Since the players stepping
+	 * before may build there, step() has to check the result again.
+	 */
+	virtual void plan() {}
+
 	/**
 	 * Called monthly by simworld.cc during simulation
 	 * @returns false if player has to be removed (bankrupt/inactive)
@@ -10,6 +10,7 @@
 #include "../api_function.h"
 #include "../api_class.h"
 #include "../script.h"
+#include "../../utils/cbuffer.h"
 #include "../../../squirrel/sq_extensions.h"
 #include "../../tool/simtool.h"
 
@@ -50,6 +51,24 @@ SQInteger set_pause_on_error(HSQUIRRELVM vm)
 	return SQ_OK;
 }
 
+SQInteger set_profiling(HSQUIRRELVM vm)
+{
+	if (script_vm_t *script = (script_vm_t*)sq_getforeignptr(vm)) {
+		bool on = param<bool>::get(vm, 2);
+		script->set_profiling(on);
+	}
+	return SQ_OK;
+}
+
+SQInteger get_profile(HSQUIRRELVM vm)
+{
+	cbuffer_t buf;
+	if (script_vm_t *script = (script_vm_t*)sq_getforeignptr(vm)) {
+		script->dump_profile(buf);
+	}
+	return param<const char*>::push(vm, buf);
+}
+
 
 
 void export_control(HSQUIRRELVM vm)
@@ -96,5 +115,20 @@ void export_control(HSQUIRRELVM vm)
 	 */
 	STATIC register_function<void(*)(bool)>(vm, set_pause_on_error, "set_pause_on_error", true);
 
+	/**
+	 * Starts or stops profiling of the script. While profiling, calls, opcodes and time
+	 * are counted for every function of the script and every call to the game.
+	 * When stopped, the profile is written to the log file of the script.
+	 * Makes the script run slower.
+	 * @param p true to start profiling
+	 */
+	STATIC register_function<void(*)(bool)>(vm, set_profiling, "set_profiling", true);
+
+	/**
+	 * Writes the profile so far to the log file of the script.
+	 * @returns the profile as text, empty if not profiling
+	 */
+	STATIC register_function<const char*(*)()>(vm, get_profile, "get_profile", true);
+
 	end_class(vm);
 }
@@ -17,6 +17,10 @@
 #include "../../descriptor/factory_desc.h"
 #include "../../simfab.h"
 
+namespace script_api {
+	declare_fake_param(factory_list_t, "factory_list_x");
+}
+
 using namespace script_api;
 
 SQInteger exp_factory_constructor(HSQUIRRELVM vm)
@@ -76,6 +80,21 @@ vector_tpl<sint64> const& get_factory_stat(fabrik_t *fab, sint32 INDEX)
 }
 
 
+// one statistic value per factory, in the order of factory_list_x
+vector_tpl<sint64> const& factory_list_get_stat(factory_list_t, uint16 month, sint32 INDEX)
+{
+	static vector_tpl<sint64> v;
+	v.clear();
+	if (month < MAX_MONTH  &&  0<=INDEX  &&  INDEX<MAX_FAB_STAT) {
+		v.reserve(welt->get_fab_list().get_count());
+		for(fabrik_t* const fab : welt->get_fab_list()) {
+			v.append(fab->get_stat_converted(month, INDEX));
+		}
+	}
+	return v;
+}
+
+
 vector_tpl<sint64> const& get_factory_production_stat(const ware_production_t *prod_slot, sint32 INDEX)
 {
 	static vector_tpl<sint64> v;
@@ -207,6 +226,36 @@ void export_factory(HSQUIRRELVM vm)
 	 */
 	register_function(vm, world_get_factory_count, "get_count",  1, "x");
 
+	/** @name Statistics of all factories at once.
+	 * Each function returns an array with one value per factory, in the same order as this list.
+	 * This is much faster than querying each factory_x separately.
+	 * @param month index of month, 0 corresponds to current month
+	 */
+	//@{
+	/// @returns array of production
+	register_method_fv(vm, &factory_list_get_stat, "get_production",     freevariable<sint32>(FAB_PRODUCTION), true);
+	/// @returns array of power consumption/production
+	register_method_fv(vm, &factory_list_get_stat, "get_power",          freevariable<sint32>(FAB_POWER), true);
+	/// @returns array of boost by electricity
+	register_method_fv(vm, &factory_list_get_stat, "get_boost_electric", freevariable<sint32>(FAB_BOOST_ELECTRIC), true);
+	/// @returns array of boost by passengers
+	register_method_fv(vm, &factory_list_get_stat, "get_boost_pax",      freevariable<sint32>(FAB_BOOST_PAX), true);
+	/// @returns array of boost by mail
+	register_method_fv(vm, &factory_list_get_stat, "get_boost_mail",     freevariable<sint32>(FAB_BOOST_MAIL), true);
+	/// @returns array of generated passengers
+	register_method_fv(vm, &factory_list_get_stat, "get_pax_generated",  freevariable<sint32>(FAB_PAX_GENERATED), true);
+	/// @returns array of departed passengers
+	register_method_fv(vm, &factory_list_get_stat, "get_pax_departed",   freevariable<sint32>(FAB_PAX_DEPARTED), true);
+	/// @returns array of arrived passengers
+	register_method_fv(vm, &factory_list_get_stat, "get_pax_arrived",    freevariable<sint32>(FAB_PAX_ARRIVED), true);
+	/// @returns array of generated mail
+	register_method_fv(vm, &factory_list_get_stat, "get_mail_generated", freevariable<sint32>(FAB_MAIL_GENERATED), true);
+	/// @returns array of departed mail
+	register_method_fv(vm, &factory_list_get_stat, "get_mail_departed",  freevariable<sint32>(FAB_MAIL_DEPARTED), true);
+	/// @returns array of arrived mail
+	register_method_fv(vm, &factory_list_get_stat, "get_mail_arrived",   freevariable<sint32>(FAB_MAIL_ARRIVED), true);
+	//@}
+
 	end_class(vm);
 
 
@@ -35,6 +35,10 @@ namespace script_api {
 };
 
 
+namespace script_api {
+	declare_fake_param(halt_list_t, "halt_list_x");
+}
+
 using namespace script_api;
 
 vector_tpl<sint64> const& get_halt_stat(const haltestelle_t *halt, sint32 INDEX)
@@ -50,6 +54,22 @@ vector_tpl<sint64> const& get_halt_stat(const haltestelle_t *halt, sint32 INDEX)
 }
 
 
+// one statistic value per halt, in the order of halt_list_x
+vector_tpl<sint64> const& halt_list_get_stat(halt_list_t, uint16 month, sint32 INDEX)
+{
+	static vector_tpl<sint64> v;
+	v.clear();
+	if (month < MAX_MONTHS  &&  0<=INDEX  &&  INDEX<MAX_HALT_COST) {
+		const vector_tpl<halthandle_t>& list = haltestelle_t::get_alle_haltestellen();
+		v.reserve(list.get_count());
+		for(halthandle_t const halt : list) {
+			v.append( halt->get_finance_history(month, INDEX) );
+		}
+	}
+	return v;
+}
+
+
 bool is_rerouting_finished()
 {
 	return haltestelle_t::get_rerouting_status() == 0  &&  haltestelle_t::get_reconnect_counter() == world()->get_schedule_counter();
@@ -166,6 +186,30 @@ void export_halt(HSQUIRRELVM vm)
 	 * @typemask halt_x()
 	 */
 	register_function(vm, world_get_halt_by_index, "_get",    2, "xi");
+
+	/** @name Statistics of all halts at once.
+	 * Each function returns an array with one value per halt, in the same order as this list.
+	 * This is much faster than querying each halt_x separately.
+	 * @param month index of month, 0 corresponds to current month
+	 */
+	//@{
+	/// @returns array of number of arrived goods
+	register_method_fv(vm, &halt_list_get_stat, "get_arrived",  freevariable<sint32>(HALT_ARRIVED), true);
+	/// @returns array of number of departed goods
+	register_method_fv(vm, &halt_list_get_stat, "get_departed", freevariable<sint32>(HALT_DEPARTED), true);
+	/// @returns array of number of waiting goods
+	register_method_fv(vm, &halt_list_get_stat, "get_waiting",  freevariable<sint32>(HALT_WAITING), true);
+	/// @returns array of number of happy passengers
+	register_method_fv(vm, &halt_list_get_stat, "get_happy",    freevariable<sint32>(HALT_HAPPY), true);
+	/// @returns array of number of unhappy passengers
+	register_method_fv(vm, &halt_list_get_stat, "get_unhappy",  freevariable<sint32>(HALT_UNHAPPY), true);
+	/// @returns array of number of passengers that could not find a route
+	register_method_fv(vm, &halt_list_get_stat, "get_noroute",  freevariable<sint32>(HALT_NOROUTE), true);
+	/// @returns array of number of arrived convoys
+	register_method_fv(vm, &halt_list_get_stat, "get_convoys",  freevariable<sint32>(HALT_CONVOIS_ARRIVED), true);
+	/// @returns array of number of passengers that walked to their destination
+	register_method_fv(vm, &halt_list_get_stat, "get_walked",   freevariable<sint32>(HALT_WALKED), true);
+	//@}
 	end_class(vm);
 
 	/**
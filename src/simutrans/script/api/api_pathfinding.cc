@@ -121,6 +121,20 @@ bool way_builder_is_allowed_step(way_builder_t *bob, grund_t *from, grund_t *to)
 }
 
 
+vector_tpl<koord3d> const& way_builder_calc_route(way_builder_t *bob, koord3d from, koord3d to)
+{
+	static vector_tpl<koord3d> route;
+	route.clear();
+	if (bob->get_desc() != NULL  &&  welt->lookup(from)  &&  welt->lookup(to)) {
+		bob->calc_route(from, to);
+		for(koord3d const& pos : bob->get_route()) {
+			route.append(pos);
+		}
+	}
+	return route;
+}
+
+
 koord3d bridge_builder_find_end_pos(player_t *player, koord3d pos, my_ribi_t mribi, const bridge_desc_t *bridge, uint32 min_length)
 {
 	const char* err;
@@ -203,6 +217,15 @@ void export_pathfinding(HSQUIRRELVM vm)
 	 * @param to to here, @p from and @p to must be adjacent.
 	 */
 	register_method(vm, way_builder_is_allowed_step, "is_allowed_step", true);
+	/**
+	 * Searches a route for a new way from @p from to @p to, using the same
+	 * search as the way building tool. Call @ref set_build_types first.
+	 * Doing the search in native code is much faster than a search in script code.
+	 * @param from start tile
+	 * @param to end tile
+	 * @returns array of tiles along the route, empty if no route was found
+	 */
+	register_method(vm, way_builder_calc_route, "calc_route", true);
 
 	end_class(vm);
 
@@ -23,6 +23,7 @@
 #include "../../builder/goods_manager.h"
 #include "../../simhalt.h"
 #include "../../simfab.h"
+#include "../../ground/grund.h"
 
 
 using namespace script_api;
@@ -223,6 +224,80 @@ SQInteger world_get_size(HSQUIRRELVM vm)
 	}
 }
 
+// maximum number of tiles scanned by one call to the world.get_*_map functions
+#define MAX_AREA_SCAN_TILES (256*256)
+
+/**
+ * Scans the rectangle between the coordinates on the stack (index 2 and 3)
+ * and pushes an array with one value per ground tile.
+ * The rectangle is traversed in script coordinates row by row,
+ * so the layout of the array does not depend on the map rotation.
+ */
+template<class F>
+static SQInteger world_scan_area(HSQUIRRELVM vm, F const& get_value)
+{
+	koord from = param<koord>::get(vm, 2);
+	koord to   = param<koord>::get(vm, 3);
+	if (!welt->is_within_limits(from)  ||  !welt->is_within_limits(to)) {
+		return sq_raise_error(vm, "Coordinates out of range");
+	}
+	coordinate_transform_t::koord_w2sq(from);
+	coordinate_transform_t::koord_w2sq(to);
+	const koord lo( min(from.x, to.x), min(from.y, to.y) );
+	const koord hi( max(from.x, to.x), max(from.y, to.y) );
+	if ((sint32)(hi.x - lo.x + 1) * (sint32)(hi.y - lo.y + 1) > MAX_AREA_SCAN_TILES) {
+		return sq_raise_error(vm, "Area too large, at most %d tiles can be scanned at once", MAX_AREA_SCAN_TILES);
+	}
+
+	sq_newarray(vm, 0);
+	for(sint16 y = lo.y; y <= hi.y; y++) {
+		for(sint16 x = lo.x; x <= hi.x; x++) {
+			koord k(x, y);
+			coordinate_transform_t::koord_sq2w(k);
+			sq_pushinteger(vm, get_value( welt->lookup_kartenboden(k) ));
+			sq_arrayappend(vm, -2);
+		}
+	}
+	return 1;
+}
+
+
+SQInteger world_get_height_map(HSQUIRRELVM vm)
+{
+	return world_scan_area(vm, [](const grund_t *gr) -> SQInteger {
+		return gr->get_hoehe();
+	});
+}
+
+
+SQInteger world_get_way_dirs_map(HSQUIRRELVM vm)
+{
+	const waytype_t wt = param<waytype_t>::get(vm, 4);
+	return world_scan_area(vm, [wt](const grund_t *gr) -> SQInteger {
+		ribi_t::ribi ribi = gr->get_weg_ribi_unmasked(wt);
+		coordinate_transform_t::ribi_w2sq(ribi);
+		return ribi;
+	});
+}
+
+
+SQInteger world_get_owner_map(HSQUIRRELVM vm)
+{
+	return world_scan_area(vm, [](const grund_t *gr) -> SQInteger {
+		// ways are always sorted first on a tile
+		return gr->obj_count() > 0  ?  gr->obj_bei(0)->get_owner_nr() : PLAYER_UNOWNED;
+	});
+}
+
+
+SQInteger world_get_halt_map(HSQUIRRELVM vm)
+{
+	return world_scan_area(vm, [](const grund_t *gr) -> SQInteger {
+		return gr->get_halt().get_id();
+	});
+}
+
+
 const char* get_pakset_name()
 {
 	return ground_desc_t::outside->get_copyright();
@@ -463,6 +538,43 @@ void export_world(HSQUIRRELVM vm, bool scenario)
 	 */
 	STATIC register_function(vm, world_get_size, "get_size", 1, ".");
 
+	/** @name Bulk queries of map areas.
+	 * These functions scan all ground tiles in the rectangle spanned by @p from and @p to
+	 * and return an array with one entry per tile. The tiles are stored row by row:
+	 * the entry for the coordinate (x,y) has the index (y - min_y) * width + (x - min_x).
+	 * At most 65536 tiles can be scanned by one call.
+	 * Raises an error if one of the coordinates is not on the map.
+	 * @param from corner of the rectangle
+	 * @param to opposite corner of the rectangle
+	 */
+	//@{
+	/**
+	 * Heights of the ground tiles.
+	 * @typemask array<integer>(coord,coord)
+	 */
+	STATIC register_function(vm, world_get_height_map, "get_height_map", 3, ". t|x|y t|x|y", true);
+	/**
+	 * Directions of the ways with waytype @p wt on the ground tiles, 0 if there is no such way.
+	 * One-way signs are ignored here, see tile_x::get_way_dirs.
+	 * @param wt waytype
+	 * @typemask array<dir>(coord,coord,way_types)
+	 */
+	STATIC register_function(vm, world_get_way_dirs_map, "get_way_dirs_map", 4, ". t|x|y t|x|y i", true);
+	/**
+	 * Player numbers of the owners of the ground tiles.
+	 * The owner of the first object on the tile (which is the way if any) is returned,
+	 * 15 if the tile is empty or its first object has no owner.
+	 * @typemask array<integer>(coord,coord)
+	 */
+	STATIC register_function(vm, world_get_owner_map, "get_owner_map", 3, ". t|x|y t|x|y", true);
+	/**
+	 * Ids of the halts on the ground tiles, 0 if there is no halt.
+	 * Use halt_x(id) to access a halt.
+	 * @typemask array<integer>(coord,coord)
+	 */
+	STATIC register_function(vm, world_get_halt_map, "get_halt_map", 3, ". t|x|y t|x|y", true);
+	//@}
+
 	end_class(vm);
 
 	/**
@@ -20,6 +20,9 @@
  * - Added @ref bridge_x, @ref tunnel_x
  * - Added @ref factory_x::get_fields_list, @ref world::get_label_list
  * - Added @ref schedule_x::current.
+ * - Added bulk queries @ref world::get_height_map, @ref world::get_way_dirs_map, @ref world::get_owner_map, @ref world::get_halt_map
+ * - Added statistics of all halts/factories at once to @ref halt_list_x and @ref factory_list_x
+ * - Added @ref way_planner_x::calc_route
  *
  * @section api-123 Release 123.0
  *
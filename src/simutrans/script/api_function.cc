@@ -4,12 +4,36 @@
  */
 
 #include "api_function.h"
+#include "script.h"
+#include "script_profiler.h"
 #include <stdio.h>
 
 #include "../sys/simsys.h"
 
 #include "../dataobj/environment.h"
 
+script_api::native_call_timer_t::native_call_timer_t(HSQUIRRELVM vm_) : vm(vm_)
+{
+	script_vm_t *script = (script_vm_t*)sq_getforeignptr(vm);
+	start = script  &&  script->get_profiler() ? script_profiler_t::get_time_us() : 0;
+}
+
+
+script_api::native_call_timer_t::~native_call_timer_t()
+{
+	if (start == 0) {
+		return;
+	}
+	// the method may have stopped profiling
+	script_vm_t *script = (script_vm_t*)sq_getforeignptr(vm);
+	if (script_profiler_t *profiler = script->get_profiler()) {
+		SQStackInfos si;
+		const char *name = SQ_SUCCEEDED(sq_stackinfos(vm, 0, &si)) ? si.funcname : NULL;
+		profiler->native_call(name, script_profiler_t::get_time_us() - start);
+	}
+}
+
+
 /**
  * Auxiliary function to register function in table/class at stack top
  */
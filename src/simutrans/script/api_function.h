@@ -202,6 +202,19 @@ namespace script_api {
 		register_method(vm, funcptr, name, true);
 	}
 
+	/**
+	 * Measures the time spent in a c++ method while the script is profiled,
+	 * see script_profiler_t.
+	 */
+	class native_call_timer_t
+	{
+		HSQUIRRELVM vm;
+		uint64 start; ///< zero if not profiling
+	public:
+		native_call_timer_t(HSQUIRRELVM vm);
+		~native_call_timer_t();
+	};
+
 	/**
 	 * The general purpose callback method to be called from squirrel.
 	 * @tparam F function pointer signature of c++ method
@@ -209,6 +222,7 @@ namespace script_api {
 	template<typename F>
 	SQInteger generic_squirrel_callback(HSQUIRRELVM vm)
 	{
+		native_call_timer_t timer(vm);
 		SQUserPointer up = NULL;
 
 		// get pointer to function
@@ -4,6 +4,7 @@
  */
 
 #include "script.h"
+#include "script_profiler.h"
 
 #include <stdarg.h>
 #include <string.h>
@@ -107,6 +108,7 @@ void export_include(HSQUIRRELVM vm, const char* include_path); // api_include.cc
 script_vm_t::script_vm_t(const char* include_path_, const char* log_name)
 {
 	pause_on_error = false;
+	profiler = NULL;
 
 	vm = sq_open(1024);
 	sqstd_seterrorhandlers(vm);
@@ -154,6 +156,7 @@ script_vm_t::script_vm_t(const char* include_path_, const char* log_name)
 
 script_vm_t::~script_vm_t()
 {
+	set_profiling(false);
 	unregister_vm(thread);
 	unregister_vm(vm);
 	// remove from suspended calls list
@@ -165,6 +168,35 @@ script_vm_t::~script_vm_t()
 	delete log;
 }
 
+void script_vm_t::set_profiling(bool on)
+{
+	if (on  &&  profiler == NULL) {
+		profiler = new script_profiler_t();
+		script_profiler_t::attach(vm, true);
+		script_profiler_t::attach(thread, true);
+		log->message("script_vm_t::set_profiling", "profiling started");
+	}
+	else if (!on  &&  profiler) {
+		cbuffer_t buf;
+		dump_profile(buf);
+		script_profiler_t::attach(vm, false);
+		script_profiler_t::attach(thread, false);
+		delete profiler;
+		profiler = NULL;
+	}
+}
+
+
+void script_vm_t::dump_profile(cbuffer_t &buf)
+{
+	if (profiler) {
+		const int start = buf.len();
+		profiler->dump(buf);
+		log->message("script_vm_t::dump_profile", "%s", buf.get_str() + start);
+	}
+}
+
+
 const char* script_vm_t::call_script(const char* filename)
 {
 	// load script
@@ -342,6 +374,10 @@ const char* script_vm_t::intern_call_function(HSQUIRRELVM job, call_type_t ct, i
 			sq_pop(job, nparams+1);
 		}
 		else {
+			script_vm_t *script = (script_vm_t*)sq_getforeignptr(job);
+			if (script  &&  script->profiler) {
+				script->profiler->suspended(job);
+			}
 			// save retvalue flag, number of parameters
 			sq_pushregistrytable(job);
 			script_api::create_slot(job, "retvalue", retvalue);
@@ -389,6 +425,9 @@ void script_vm_t::intern_resume_call(HSQUIRRELVM job)
 	}
 
 	// resume v.m.
+	if (profiler) {
+		profiler->resumed(job);
+	}
 	if (!SQ_SUCCEEDED(sq_resumevm(job, retvalue, 10000))) {
 		retvalue = false;
 	}
@@ -428,6 +467,9 @@ void script_vm_t::intern_resume_call(HSQUIRRELVM job)
 		}
 	}
 	else {
+		if (profiler) {
+			profiler->suspended(job);
+		}
 		if (retvalue) {
 			sq_poptop(job);
 		}
@@ -16,7 +16,9 @@
 #include "../utils/plainstring.h"
 #include <string>
 
+class cbuffer_t;
 class log_t;
+class script_profiler_t;
 template<class key_t, class value_t> class inthashtable_tpl;
 void sq_setwakeupretvalue(HSQUIRRELVM v); //sq_extensions
 
@@ -169,9 +171,25 @@ private:
 	/// path to files to #include
 	plainstring include_path;
 
+	/// only while profiling
+	script_profiler_t *profiler;
+
 public:
 	bool pause_on_error;
 
+	/// @{
+	/// @name Profiling of the script, see script_profiler_t
+
+	/// starts or stops profiling, on stop the profile is written to the log
+	void set_profiling(bool on);
+
+	/// @returns NULL if not profiling
+	script_profiler_t *get_profiler() const { return profiler; }
+
+	/// appends the profile so far to @p buf and writes it to the log
+	void dump_profile(cbuffer_t &buf);
+	/// @}
+
 private:
 	/// @{
 	/// @name Helper functions to call, suspend, queue calls to scripted functions
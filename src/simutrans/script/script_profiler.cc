@@ -0,0 +1,227 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include "script_profiler.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "script.h"
+#include "../../squirrel/sq_extensions.h"
+#include "../utils/cbuffer.h"
+
+
+script_profiler_t::function_key_hash_t::diff_type script_profiler_t::function_key_hash_t::comp(const function_key_t &a, const function_key_t &b)
+{
+	if(  a.src != b.src  ) {
+		return a.src < b.src ? -1 : 1;
+	}
+	if(  a.name != b.name  ) {
+		return a.name < b.name ? -1 : 1;
+	}
+	return (diff_type)a.line - b.line;
+}
+
+
+script_profiler_t::script_profiler_t() :
+	suspends(0),
+	resumes(0)
+{
+	start_time = get_time_us();
+}
+
+
+script_profiler_t::~script_profiler_t()
+{
+	clear_ptr_vector( stacks );
+}
+
+
+uint64 script_profiler_t::get_time_us()
+{
+	return (uint64)std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+
+void script_profiler_t::attach(HSQUIRRELVM vm, bool on)
+{
+	sq_setnativedebughook( vm, on ? debug_hook : NULL );
+}
+
+
+void script_profiler_t::debug_hook(HSQUIRRELVM vm, SQInteger type, const SQChar *src, SQInteger line, const SQChar *fname)
+{
+	script_vm_t *script = (script_vm_t*)sq_getforeignptr(vm);
+	script_profiler_t *profiler = script ? script->get_profiler() : NULL;
+	if(  profiler == NULL  ) {
+		return;
+	}
+	switch(  type  ) {
+		case 'c': profiler->enter( vm, src, line, fname ); break;
+		case 'r': profiler->leave( vm, src, fname ); break;
+		default: ;
+	}
+}
+
+
+script_profiler_t::call_stack_t &script_profiler_t::get_stack(HSQUIRRELVM vm)
+{
+	// there is only the vm and its thread
+	for(call_stack_t *stack : stacks) {
+		if(  stack->vm == vm  ) {
+			return *stack;
+		}
+	}
+	call_stack_t *stack = new call_stack_t();
+	stack->vm = vm;
+	stack->suspended_at = 0;
+	stack->suspended_time = 0;
+	stacks.append( stack );
+	return *stack;
+}
+
+
+uint32 script_profiler_t::get_function(const SQChar *src, SQInteger line, const SQChar *fname)
+{
+	function_key_t key;
+	key.src = src;
+	key.name = fname;
+	key.line = (sint32)line;
+
+	if(  const uint32 *index = function_index.access( key )  ) {
+		return *index;
+	}
+
+	function_stats_t f;
+	f.key = key;
+	f.src = src ? src : "?";
+	f.name = fname ? fname : "unnamed";
+	f.calls = 0;
+	f.ops = f.self_ops = 0;
+	f.time_us = f.self_time_us = 0;
+	functions.append( f );
+	function_index.put( key, functions.get_count() - 1 );
+	return functions.get_count() - 1;
+}
+
+
+void script_profiler_t::enter(HSQUIRRELVM vm, const SQChar *src, SQInteger line, const SQChar *fname)
+{
+	call_stack_t &stack = get_stack( vm );
+
+	frame_t frame;
+	frame.function = get_function( src, line, fname );
+	frame.start_ops = sq_get_ops_executed( vm );
+	frame.child_ops = 0;
+	frame.start_time = get_time_us();
+	frame.child_time = 0;
+	frame.start_suspended = stack.suspended_time;
+	stack.frames.append( frame );
+
+	functions[frame.function].calls++;
+}
+
+
+void script_profiler_t::leave(HSQUIRRELVM vm, const SQChar *src, const SQChar *fname)
+{
+	call_stack_t &stack = get_stack( vm );
+	if(  stack.frames.empty()  ) {
+		// entered before profiling started
+		return;
+	}
+	frame_t frame = stack.frames.back();
+	function_stats_t &f = functions[frame.function];
+	if(  f.key.src != src  ||  f.key.name != fname  ) {
+		// i.e. the end of a resumed generator, which was not entered by a call
+		return;
+	}
+	stack.frames.pop_back();
+
+	const sint64 ops = sq_get_ops_executed( vm ) - frame.start_ops;
+	const uint64 time = get_time_us() - frame.start_time - (stack.suspended_time - frame.start_suspended);
+
+	f.ops += ops;
+	f.self_ops += ops - frame.child_ops;
+	f.time_us += time;
+	f.self_time_us += time - frame.child_time;
+
+	if(  !stack.frames.empty()  ) {
+		stack.frames.back().child_ops += ops;
+		stack.frames.back().child_time += time;
+	}
+}
+
+
+void script_profiler_t::native_call(const char *name, uint64 time_us)
+{
+	uint32 index;
+	if(  const uint32 *i = native_index.access( name )  ) {
+		index = *i;
+	}
+	else {
+		native_stats_t n;
+		n.name = name ? name : "unnamed";
+		n.calls = 0;
+		n.time_us = 0;
+		natives.append( n );
+		index = natives.get_count() - 1;
+		native_index.put( name, index );
+	}
+	natives[index].calls++;
+	natives[index].time_us += time_us;
+}
+
+
+void script_profiler_t::suspended(HSQUIRRELVM vm)
+{
+	call_stack_t &stack = get_stack( vm );
+	stack.suspended_at = get_time_us();
+	suspends++;
+}
+
+
+void script_profiler_t::resumed(HSQUIRRELVM vm)
+{
+	call_stack_t &stack = get_stack( vm );
+	if(  stack.suspended_at  ) {
+		stack.suspended_time += get_time_us() - stack.suspended_at;
+		stack.suspended_at = 0;
+	}
+	resumes++;
+}
+
+
+void script_profiler_t::dump(cbuffer_t &buf) const
+{
+	buf.printf( "Script profile of the last %.1f s: %u suspensions, %u resumes\n", (get_time_us() - start_time) / 1e6, suspends, resumes );
+
+	// scripted functions, most opcodes spent in the function itself first
+	vector_tpl<uint32> order( functions.get_count() );
+	for(  uint32 i = 0;  i < functions.get_count();  i++  ) {
+		order.append( i );
+	}
+	std::sort( order.begin(), order.end(), [this](uint32 a, uint32 b) { return functions[a].self_ops > functions[b].self_ops; } );
+
+	buf.append( "\n    calls        ops   self ops        ms    self ms  function (self includes calls to c++)\n" );
+	for(uint32 i : order) {
+		const function_stats_t &f = functions[i];
+		buf.printf( "%9u %10lld %10lld %9.2f %9.2f  %s (%s:%d)\n",
+			f.calls, (long long)f.ops, (long long)f.self_ops, f.time_us / 1000.0, f.self_time_us / 1000.0,
+			f.name.c_str(), f.src.c_str(), f.key.line );
+	}
+
+	// c++ functions of the script api, most time first
+	order.clear();
+	for(  uint32 i = 0;  i < natives.get_count();  i++  ) {
+		order.append( i );
+	}
+	std::sort( order.begin(), order.end(), [this](uint32 a, uint32 b) { return natives[a].time_us > natives[b].time_us; } );
+
+	buf.append( "\n    calls        ms  c++ function\n" );
+	for(uint32 i : order) {
+		const native_stats_t &n = natives[i];
+		buf.printf( "%9u %9.2f  %s\n", n.calls, n.time_us / 1000.0, n.name.c_str() );
+	}
+}
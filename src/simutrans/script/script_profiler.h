@@ -0,0 +1,121 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef SCRIPT_SCRIPT_PROFILER_H
+#define SCRIPT_SCRIPT_PROFILER_H
+
+
+#include "../simtypes.h"
+#include "../../squirrel/squirrel.h"
+#include "../tpl/ptrhashtable_tpl.h"
+#include "../tpl/vector_tpl.h"
+#include "../utils/plainstring.h"
+
+class cbuffer_t;
+
+
+/**
+ * Profiler for scenarios and scripted AIs.
+ * Counts per scripted function the calls, the opcodes and the wall time,
+ * both including and excluding the functions called from it (self),
+ * per c++ function of the script api the calls and the time,
+ * and how often the script was suspended.
+ * Time while the script is suspended is not counted.
+ *
+ * Scripted functions are seen through the squirrel debug hook,
+ * which is only set while profiling.
+ */
+class script_profiler_t
+{
+public:
+	script_profiler_t();
+	~script_profiler_t();
+
+	/// starts or stops profiling the virtual machine @p vm
+	static void attach(HSQUIRRELVM vm, bool on);
+
+	/// call and return of scripted functions, set as squirrel debug hook
+	static void debug_hook(HSQUIRRELVM vm, SQInteger type, const SQChar *src, SQInteger line, const SQChar *fname);
+
+	/// call to the c++ function @p name took @p time_us microseconds
+	void native_call(const char *name, uint64 time_us);
+
+	void suspended(HSQUIRRELVM vm);
+	void resumed(HSQUIRRELVM vm);
+
+	/// prints the tables of scripted and c++ functions, the most expensive first
+	void dump(cbuffer_t &buf) const;
+
+	static uint64 get_time_us();
+
+private:
+	/// the strings belong to squirrel, they are only compared by address
+	struct function_key_t
+	{
+		const SQChar *src, *name;
+		sint32 line;
+	};
+
+	struct function_key_hash_t
+	{
+		typedef sint64 diff_type;
+		static uint32 hash(const function_key_t &key) { return (uint32)((size_t)key.src ^ (size_t)key.name) + key.line; }
+		static diff_type comp(const function_key_t &a, const function_key_t &b);
+	};
+
+	struct function_stats_t
+	{
+		function_key_t key;
+		plainstring src, name;
+		uint32 calls;
+		sint64 ops, self_ops;
+		uint64 time_us, self_time_us;
+	};
+
+	struct native_stats_t
+	{
+		plainstring name;
+		uint32 calls;
+		uint64 time_us;
+	};
+
+	struct frame_t
+	{
+		uint32 function;
+		sint64 start_ops, child_ops;
+		uint64 start_time, child_time;
+		/// suspended time of the stack when entering the frame
+		uint64 start_suspended;
+	};
+
+	/// the calls in progress of one virtual machine
+	struct call_stack_t
+	{
+		HSQUIRRELVM vm;
+		vector_tpl<frame_t> frames;
+		uint64 suspended_at;
+		/// total time this vm was suspended with frames open
+		uint64 suspended_time;
+	};
+
+	vector_tpl<function_stats_t> functions;
+	hashtable_tpl<function_key_t, uint32, function_key_hash_t> function_index;
+
+	vector_tpl<native_stats_t> natives;
+	ptrhashtable_tpl<const char *, uint32> native_index;
+	vector_tpl<call_stack_t *> stacks;
+
+	uint32 suspends, resumes;
+	uint64 start_time;
+
+	call_stack_t &get_stack(HSQUIRRELVM vm);
+
+	uint32 get_function(const SQChar *src, SQInteger line, const SQChar *fname);
+
+	void enter(HSQUIRRELVM vm, const SQChar *src, SQInteger line, const SQChar *fname);
+	void leave(HSQUIRRELVM vm, const SQChar *src, const SQChar *fname);
+};
+
+#endif
@@ -52,6 +52,8 @@
 #include "utils/simstring.h"
 #include "utils/cbuffer.h"
 
+#include "tpl/small_vector_tpl.h"
+
 #include "vehicle/air_vehicle.h"
 #include "vehicle/overtaker.h"
 #include "vehicle/rail_vehicle.h"
@@ -65,6 +67,11 @@
  */
 #define WTT_LOADING 2000
 
+/*
+ * Convois waiting longer than this (ms) leave the sync list until the waiting is over
+ */
+#define CONVOI_SLEEP_TIME 500
+
 
 karte_ptr_t convoi_t::welt;
 
@@ -127,6 +134,12 @@ void convoi_t::init(player_t *player)
 	has_obsolete = false;
 	no_load = false;
 	wait_lock = 0;
+	asleep = false;
+	wake_tick = 0;
+	loading_length_pos = koord3d::invalid;
+	loading_length_dir = ribi_t::none;
+	loading_length_version = 0;
+	vehicles_loading_cached = 0;
 	arrived_time = 0;
 
 	jahresgewinn = 0;
@@ -206,7 +219,9 @@ DBG_MESSAGE("convoi_t::~convoi_t()", "destroying %d, %p", self.get_id(), this);
 		welt->get_viewport()->set_follow_convoi( convoihandle_t() );
 	}
 
-	welt->sync.remove( this );
+	if(  !asleep  ) {
+		welt->sync.remove( this );
+	}
 	welt->rem_convoi( self );
 
 	// if lineless convoy -> unregister from stops
@@ -706,6 +721,9 @@ static inline sint32 res_power(sint64 speed, sint32 total_power, sint64 friction
 
 /* Calculates (and sets) new akt_speed
  * needed for driving, entering and leaving a depot)
+ * Done per convoy in its sync_step: copying all convoys into arrays first and
+ * integrating them in one loop was measured slower, since the copy touches every
+ * convoy once more and the integration itself is only a few operations.
  */
 void convoi_t::calc_acceleration(uint32 delta_t)
 {
@@ -886,6 +904,14 @@ sync_result convoi_t::sync_step(uint32 delta_t)
 	// still have to wait before next action?
 	wait_lock = max(0, (int)wait_lock - delta_t);
 	if(wait_lock > 0) {
+		if(  wait_lock > CONVOI_SLEEP_TIME  ) {
+			// nothing to do for a while: wait outside of the sync list
+			asleep = true;
+			wake_tick = welt->get_ticks() + wait_lock;
+			wait_lock = 0;
+			welt->sleep_convoi( self, wake_tick );
+			return SYNC_REMOVE;
+		}
 		return SYNC_OK;
 	}
 
@@ -1173,17 +1199,49 @@ bool convoi_t::drive_to()
  */
 void convoi_t::suche_neue_route()
 {
+	wake_up();
 	state = ROUTING_1;
 	wait_lock = 0;
 }
 
 
+bool convoi_t::end_sleep(uint32 tick)
+{
+	if(  !asleep  ||  wake_tick != tick  ) {
+		return false;
+	}
+	asleep = false;
+	return true;
+}
+
+
+void convoi_t::wake_up()
+{
+	if(  !asleep  ) {
+		return;
+	}
+	// continue with the remaining waiting time, unless the caller changes it
+	wait_lock = max( (sint32)wait_lock, (sint32)(wake_tick - welt->get_ticks()) );
+	if(  welt->sync.is_stepping()  ) {
+		// the sync list cannot be changed now, so it goes back with the next sync step
+		if(  wake_tick != welt->get_ticks()  ) {
+			wake_tick = welt->get_ticks();
+			welt->sleep_convoi( self, wake_tick );
+		}
+	}
+	else {
+		asleep = false;
+		welt->sync.add( this );
+	}
+}
+
+
 /**
  * Asynchrne step methode des Convois
  */
 void convoi_t::step()
 {
-	if(  wait_lock > 0  ) {
+	if(  wait_lock > 0  ||  asleep  ) {
 		return;
 	}
 
@@ -1530,6 +1588,7 @@ void convoi_t::betrete_depot(depot_t *dep)
 
 void convoi_t::start()
 {
+	wake_up();
 	if(  state == EDIT_SCHEDULE  &&  schedule  &&  schedule->is_editing_finished()  ) {
 		// go to defined starting state
 		wait_lock = 0;
@@ -1687,6 +1746,7 @@ DBG_MESSAGE("convoi_t::add_vehicle()","extend array_tpl to %i totals.",fahr.get_
 			fahr[vehicle_count] = v;
 		}
 		vehicle_count ++;
+		loading_length_pos = koord3d::invalid;
 
 		const vehicle_desc_t *info = v->get_desc();
 		if(info->get_power()) {
@@ -1739,6 +1799,7 @@ vehicle_t *convoi_t::remove_vehicle_at(uint16 i)
 
 			--vehicle_count;
 			fahr[vehicle_count] = NULL;
+			loading_length_pos = koord3d::invalid;
 
 			const vehicle_desc_t *info = v->get_desc();
 			sum_power -= info->get_power();
@@ -1889,6 +1950,7 @@ bool convoi_t::set_schedule(schedule_t * f)
 	}
 	// to avoid jumping trains
 	alte_richtung = fahr[0]->get_direction();
+	wake_up();
 	wait_lock = 0;
 	return true;
 }
@@ -2243,8 +2305,15 @@ void convoi_t::rdwr(loadsave_t *file)
 	}
 
 	sint32 wl = wait_lock;
+	if(  asleep  ) {
+		// the remaining waiting time
+		wl = max( wl, (sint32)(wake_tick - welt->get_ticks()) );
+	}
 	file->rdwr_long(wl);
-	wait_lock = clamp(wl, 0, 0xFFFF);
+	if(  file->is_loading()  ) {
+		// a sleeping convoy keeps sleeping, when saving only the file gets its remaining time
+		wait_lock = clamp(wl, 0, 0xFFFF);
+	}
 
 	bool dummy_bool=false;
 	file->rdwr_bool(dummy_bool);
@@ -2771,6 +2840,7 @@ void convoi_t::open_schedule_window( bool show )
 	if(state!=INITIAL) {
 		state = EDIT_SCHEDULE;
 	}
+	wake_up();
 	wait_lock = 25000;
 	alte_richtung = fahr[0]->get_direction();
 
@@ -2901,6 +2971,9 @@ uint32 convoi_t::get_departure_ticks(uint32 ticks_at_arrival) const
  */
 void convoi_t::hat_gehalten(halthandle_t halt)
 {
+	// the halt may load while we sleep, the new waiting time then starts now
+	wake_up();
+
 	// now find out station length
 	uint16 vehicles_loading = 0;
 	if(fahr[0]->get_desc()->get_waytype() == water_wt) {
@@ -2911,6 +2984,10 @@ void convoi_t::hat_gehalten(halthandle_t halt)
 		vehicles_loading = 1;
 		// one vehicle, which fits into one tile
 	}
+	else if(  loading_length_pos == fahr[0]->get_pos()  &&  loading_length_dir == fahr[0]->get_direction()  &&  loading_length_version == haltestelle_t::get_layout_version()  ) {
+		// same stop as last time
+		vehicles_loading = vehicles_loading_cached;
+	}
 	else {
 		// difference between actual station length and vehicle lenghts
 		sint16 station_length = -fahr[vehicles_loading]->get_desc()->get_length();
@@ -2951,7 +3028,11 @@ void convoi_t::hat_gehalten(halthandle_t halt)
 
 		}  while(  gr  &&  gr->get_halt() == halt  );
 		// finished
-station_tile_search_ready: ;
+station_tile_search_ready:
+		loading_length_pos = fahr[0]->get_pos();
+		loading_length_dir = fahr[0]->get_direction();
+		loading_length_version = haltestelle_t::get_layout_version();
+		vehicles_loading_cached = vehicles_loading;
 	}
 
 	// next stop in schedule will be a depot
@@ -2963,14 +3044,17 @@ station_tile_search_ready: ;
 	bool all_overcrowded = true;
 
 	// prepare a list of all destination halts in the schedule
-	vector_tpl<halthandle_t> destination_halts(schedule->get_count());
+	// (most schedules are short enough to need no memory from the heap)
+	small_vector_tpl<halthandle_t, 16> destination_halts;
+	destination_halts.reserve(schedule->get_count());
 	if (!no_load) {
 		const uint8 count = schedule->get_count();
+		const minivec_tpl<halthandle_t> &plan_halts = schedule->get_halts(owner);
 		bool first_entry = true;
 		for(  uint8 i=1;  i<count;  i++  ) {
 			const uint8 wrap_i = (i + schedule->get_current_stop()) % count;
 
-			const halthandle_t plan_halt = haltestelle_t::get_halt(schedule->entries[wrap_i].pos, owner);
+			const halthandle_t plan_halt = plan_halts[wrap_i];
 			if(plan_halt == halt) {
 				// we will come later here again ...
 				// the following halt is the same => there will never be a halt to serve
@@ -3247,6 +3331,7 @@ void convoi_t::self_destruct()
 		destroy();
 	}
 	else {
+		wake_up();
 		state = SELF_DESTRUCT;
 		wait_lock = 0;
 	}
@@ -3567,6 +3652,7 @@ void convoi_t::check_pending_updates()
 				state = EDIT_SCHEDULE;
 			}
 			// make this change immediately
+			wake_up();
 			if(  state!=LOADING  ) {
 				wait_lock = 0;
 			}
@@ -114,7 +114,8 @@ private:
 	uint8 freight_info_resort : 1; ///< the convoi caches its freight info; it is only recalculation after loading or resorting
 	uint8 has_obsolete        : 1; ///< true, if at least one vehicle of a convoi is obsolete
 	uint8 is_electric         : 1; ///< true, if there is at least one engine that requires catenary
-	// 3 bits free
+	uint8 asleep              : 1; ///< waits outside the sync list until wake_tick, see karte_t::sleep_convoi()
+	// 2 bits free
 
 	states state;
 
@@ -263,6 +264,19 @@ private:
 	/// struct holds new financial history for convoi
 	sint64 financial_history[MAX_MONTHS][MAX_CONVOI_COST];
 
+	/// while asleep: the ticks at which wait_lock is over
+	uint32 wake_tick;
+
+	/**
+	 * The number of vehicles in the station found at the last stop in hat_gehalten(),
+	 * valid while the front stops at the same position in the same direction
+	 * and neither the vehicles nor the halts changed.
+	 */
+	koord3d loading_length_pos;
+	ribi_t::ribi loading_length_dir;
+	uint32 loading_length_version;
+	uint16 vehicles_loading_cached;
+
 private:
 	/**
 	* Initialize all variables with default values.
@@ -297,6 +311,12 @@ private:
 	// returns the index of the vehicle at position length (16=1 tile)
 	int get_vehicle_at_length(uint16);
 
+	/**
+	 * A sleeping convoi goes back into the sync list, so the caller can change its state.
+	 * Must be called before wait_lock is changed from outside of sync_step() and step().
+	 */
+	void wake_up();
+
 	/**
 	* calculate income for last hop
 	* only used for entering depot or recalculating routes when a schedule window is opened
@@ -535,6 +555,12 @@ public:
 	 */
 	sync_result sync_step(uint32 delta_t);
 
+	/**
+	 * Called by the world, when the sleeping time, which started with sync_step(), is over.
+	 * @returns false if the convoi was woken up earlier or slept until another time
+	 */
+	bool end_sleep(uint32 tick);
+
 	/**
 	 * All things like route search or loading, that may take a little
 	 */
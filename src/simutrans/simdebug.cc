@@ -16,12 +16,33 @@
 log_t *dbg = NULL;
 
 
+/**
+ * Writes what is still queued when the program ends.
+ */
+static void stop_async_logging()
+{
+	if(  dbg  ) {
+		dbg->set_async( false );
+	}
+}
+
+
 /**
  * Inits logging facility.
  */
 void init_logging(const char* logname, bool force_flush, bool log_debug, const char* greeting, const char* syslogtag )
 {
+	static bool registered = false;
+	if(  dbg  ) {
+		// the old log is not deleted, but its queue must be written first
+		dbg->set_async( false );
+	}
 	dbg = new log_t( logname, force_flush, log_debug, true, greeting, syslogtag );
+	dbg->set_async( true );
+	if(  !registered  ) {
+		atexit( stop_async_logging );
+		registered = true;
+	}
 }
 
 
@@ -751,6 +751,7 @@ fabrik_t::fabrik_t(loadsave_t* file)
 	pos = koord3d::invalid;
 	transformers.clear();
     currently_producing = false;
+	pending_power = 0;
 
 	rdwr(file);
 
@@ -804,6 +805,7 @@ fabrik_t::fabrik_t(koord3d pos_, player_t* owner, const factory_desc_t* factory_
 	activity_count = 0;
 	currently_requiring_power = false;
 	currently_producing = false;
+	pending_power = 0;
 	total_input = total_transit = total_output = 0;
 	status = STATUS_NOTHING;
 	consumer_active_last_month = 0;
@@ -1096,21 +1098,56 @@ void fabrik_t::remove_field_at(koord pos)
 }
 
 
+// position of the first tile of a factory in a row by row scan of an area
+struct factory_first_tile_t
+{
+	koord first;
+	fabrik_t *fab;
+};
+
+
+static bool compare_factory_first_tile(const factory_first_tile_t &a, const factory_first_tile_t &b)
+{
+	return a.first.y < b.first.y  ||  (a.first.y == b.first.y  &&  a.first.x < b.first.x);
+}
+
+
 vector_tpl<fabrik_t *> &fabrik_t::sind_da_welche(koord min_pos, koord max_pos)
 {
 	static vector_tpl <fabrik_t*> factory_list(16);
 	factory_list.clear();
 
-	for(int y=min_pos.y; y<=max_pos.y; y++) {
-		for(int x=min_pos.x; x<=max_pos.x; x++) {
-			fabrik_t *fab=get_fab(koord(x,y));
-			if(fab) {
-				if (factory_list.append_unique(fab)) {
-//DBG_MESSAGE("fabrik_t::sind_da_welche()","appended factory %s at (%i,%i)",gr->first_obj()->get_fabrik()->get_desc()->get_name(),x,y);
+	vector_tpl<fabrik_t *> candidates;
+	welt->find_factories( min_pos, max_pos, candidates );
+	if(  candidates.empty()  ) {
+		return factory_list;
+	}
+
+	// the index only knows the bounding rectangles, so check the tiles;
+	// also keep the order of a row by row scan over the area
+	vector_tpl<factory_first_tile_t> found( candidates.get_count() );
+	for(fabrik_t* const fab : candidates) {
+		koord fab_min, fab_max;
+		fab->get_building_area( fab_min, fab_max );
+		fab_min.clip_min( min_pos );
+		fab_max.clip_max( max_pos );
+		bool hit = false;
+		for(  koord k = fab_min;  !hit  &&  k.y <= fab_max.y;  k.y++  ) {
+			for(  k.x = fab_min.x;  k.x <= fab_max.x;  k.x++  ) {
+				if(  get_fab( k ) == fab  ) {
+					factory_first_tile_t f;
+					f.first = k;
+					f.fab = fab;
+					found.insert_ordered( f, compare_factory_first_tile );
+					hit = true;
+					break;
 				}
 			}
 		}
 	}
+	for(factory_first_tile_t const& f : found) {
+		factory_list.append( f.fab );
+	}
 	return factory_list;
 }
 
@@ -1850,7 +1887,7 @@ sint32 fabrik_t::get_jit2_power_boost() const
 }
 
 
-void fabrik_t::step(uint32 delta_t)
+void fabrik_t::step_production(uint32 delta_t)
 {
 	// Only do something if advancing in time.
 	if(  delta_t==0  ) {
@@ -2243,7 +2280,7 @@ void fabrik_t::step(uint32 delta_t)
 
 				// normalize work with respect to input number
 				work /= input.get_count();
-				set_power_supply(power);
+				defer_power_supply(power);
 
 				break;
 			}
@@ -2297,7 +2334,7 @@ void fabrik_t::step(uint32 delta_t)
 				if(  desc->is_electricity_producer()  ) {
 					// compute power production
 					uint64 pp = ((uint64)scaled_electric_demand * (uint64)boost * (uint64)work) >> (DEFAULT_PRODUCTION_FACTOR_BITS + WORK_BITS);
-					set_power_supply((uint32)pp);
+					defer_power_supply((uint32)pp);
 				}
 
 				break;
@@ -2313,7 +2350,7 @@ void fabrik_t::step(uint32 delta_t)
 
 				// compute power production
 				uint64 pp = ((uint64)scaled_electric_demand * (uint64)boost) >> DEFAULT_PRODUCTION_FACTOR_BITS;
-				set_power_supply((uint32)pp);
+				defer_power_supply((uint32)pp);
 
 				break;
 			}
@@ -2326,7 +2363,7 @@ void fabrik_t::step(uint32 delta_t)
 				if(  desc->is_electricity_producer()  ) {
 					currently_requiring_power = true;
 					currently_producing = true;
-					set_power_supply((uint32)( ((sint64)scaled_electric_demand * (sint64)(DEFAULT_PRODUCTION_FACTOR + prodfactor_pax + prodfactor_mail)) >> DEFAULT_PRODUCTION_FACTOR_BITS ));
+					defer_power_supply((uint32)( ((sint64)scaled_electric_demand * (sint64)(DEFAULT_PRODUCTION_FACTOR + prodfactor_pax + prodfactor_mail)) >> DEFAULT_PRODUCTION_FACTOR_BITS ));
 				}
 				break;
 			}
@@ -2389,10 +2426,6 @@ void fabrik_t::step(uint32 delta_t)
 		}
 	}
 
-	/// Book the weighted sums for statistics.
-
-	book_weighted_sums( delta_t );
-
 	/// Power ordering logic.
 
 	switch(  boost_type  ) {
@@ -2400,10 +2433,10 @@ void fabrik_t::step(uint32 delta_t)
 			// draw a fixed amount of power when working sufficiently, otherwise draw no power
 			if(  !desc->is_electricity_producer()  ) {
 				if(  currently_requiring_power  ) {
-					set_power_demand(scaled_electric_demand);
+					defer_power_demand(scaled_electric_demand);
 				}
 				else {
-					set_power_demand(0);
+					defer_power_demand(0);
 				}
 			}
 			break;
@@ -2411,7 +2444,7 @@ void fabrik_t::step(uint32 delta_t)
 		case BL_POWER: {
 			// compute power demand
 			uint64 pd = ((uint64)scaled_electric_demand * (uint64)boost * (uint64)work) >> (DEFAULT_PRODUCTION_FACTOR_BITS + WORK_BITS);
-			set_power_demand((uint32)pd);
+			defer_power_demand((uint32)pd);
 
 			break;
 		}
@@ -2420,6 +2453,28 @@ void fabrik_t::step(uint32 delta_t)
 			break;
 		}
 	};
+}
+
+
+void fabrik_t::step_distribution(uint32 delta_t)
+{
+	if(  delta_t==0  ) {
+		return;
+	}
+
+	// power supply first, the statistics use the new supply but the old demand
+	if(  pending_power & PENDING_SUPPLY  ) {
+		set_power_supply( pending_power_supply );
+	}
+
+	/// Book the weighted sums for statistics.
+
+	book_weighted_sums( delta_t );
+
+	if(  pending_power & PENDING_DEMAND  ) {
+		set_power_demand( pending_power_demand );
+	}
+	pending_power = 0;
 
 	/// Periodic tasks.
 
@@ -3286,6 +3341,13 @@ void fabrik_t::get_tile_list( vector_tpl<koord> &tile_list ) const
 }
 
 
+void fabrik_t::get_building_area( koord &min, koord &max ) const
+{
+	min = pos_origin.get_2d();
+	max = min + desc->get_building()->get_size( rotate ) - koord( 1, 1 );
+}
+
+
 void fabrik_t::get_fields_list( vector_tpl<grund_t*> &fields_list ) const
 {
 	fields_list.clear();
@@ -327,6 +327,14 @@ private:
 	// there is input or output and we do something with it ...
 	bool currently_producing;
 
+	/// changes of the power supply and demand by step_production(), applied by step_distribution()
+	enum { PENDING_SUPPLY = 1, PENDING_DEMAND = 2 };
+	uint8 pending_power;
+	uint32 pending_power_supply, pending_power_demand;
+
+	void defer_power_supply(uint32 supply) { pending_power_supply = supply; pending_power |= PENDING_SUPPLY; }
+	void defer_power_demand(uint32 demand) { pending_power_demand = demand; pending_power |= PENDING_DEMAND; }
+
 	uint32 last_sound_ms;
 
 	uint32 total_input, total_transit, total_output;
@@ -592,7 +600,20 @@ public:
 	 */
 	sint32 get_jit2_power_boost() const;
 
-	void step(uint32 delta_t);                  // factory muss auch arbeiten
+	/**
+	 * First half of the step: production, consumption, boosts and orders.
+	 * Changes nothing but this factory, so it may run in parallel for all factories.
+	 */
+	void step_production(uint32 delta_t);
+
+	/**
+	 * Second half of the step: power, statistics, distribution of the goods to the halts,
+	 * smoke and expansion. Must be called in the order of the factory list after step_production().
+	 * All factories produce before the first one distributes. Goods delivered right away to a
+	 * factory later in the list (see haltestelle_t::liefere_an_fabrik()) are thus consumed one step later than
+	 * when each factory produced and distributed in turn.
+	 */
+	void step_distribution(uint32 delta_t);
 	void new_month();
 
 	char const* get_name() const;
@@ -621,6 +642,9 @@ public:
 	 */
 	void get_tile_list( vector_tpl<koord> &tile_list ) const;
 
+	/// top left and bottom right corner of the rectangle covered by the factory building (without fields)
+	void get_building_area( koord &min, koord &max ) const;
+
 	/*
 	 * Fills the vector with the tiles of the fields.
 	 */
@@ -40,6 +40,7 @@
 #include "dataobj/loadsave.h"
 #include "dataobj/translator.h"
 #include "dataobj/environment.h"
+#include "dataobj/step_arena.h"
 
 #include "obj/gebaeude.h"
 #include "obj/label.h"
@@ -51,6 +52,7 @@
 
 #include "utils/simrandom.h"
 #include "utils/simstring.h"
+#include "utils/perf_timer.h"
 
 #include "tpl/binary_heap_tpl.h"
 
@@ -71,6 +73,8 @@ inthashtable_tpl<sint32,halthandle_t> *haltestelle_t::all_koords = NULL;
 
 uint8 haltestelle_t::status_step = 0;
 uint8 haltestelle_t::reconnect_counter = 0;
+uint32 haltestelle_t::layout_version = 1;
+vector_tpl<halthandle_t> haltestelle_t::pending_factory_relinks;
 
 
 static vector_tpl<convoihandle_t>stale_convois;
@@ -417,6 +421,7 @@ void haltestelle_t::destroy_all()
 	delete all_koords;
 	all_koords = NULL;
 	status_step = 0;
+	pending_factory_relinks.clear();
 }
 
 
@@ -438,6 +443,7 @@ haltestelle_t::haltestelle_t(loadsave_t* file)
 
 	sortierung = freight_list_sorter_t::by_name;
 	resort_freight_info = true;
+	factory_relink_pending = false;
 
 	rdwr(file);
 
@@ -474,6 +480,7 @@ haltestelle_t::haltestelle_t(koord k, player_t* player)
 	last_bar_count = 0;
 
 	sortierung = freight_list_sorter_t::by_name;
+	factory_relink_pending = false;
 	init_financial_history();
 }
 
@@ -1053,7 +1060,7 @@ void haltestelle_t::reroute_goods(sint16 &units_remaining)
 
 			// first: clean out the array
 			vector_tpl<ware_t> * warray = cargo[last_catg_index];
-			vector_tpl<ware_t> * new_warray = new vector_tpl<ware_t>(warray->get_count());
+			step_vector_tpl<ware_t> new_warray(warray->get_count());
 
 			for (size_t j = warray->get_count(); j-- != 0;) {
 				ware_t & ware = (*warray)[j];
@@ -1072,22 +1079,23 @@ void haltestelle_t::reroute_goods(sint16 &units_remaining)
 				}
 
 				// add to new array
-				new_warray->append( ware );
+				new_warray.append( ware );
 			}
 
 			// delete, if nothing connects here
-			if(  new_warray->empty()  ) {
-				if(  all_links[last_catg_index].connections.empty()  ) {
-					// no connections from here => delete
-					delete new_warray;
-					new_warray = NULL;
+			if(  new_warray.empty()  &&  all_links[last_catg_index].connections.empty()  ) {
+				// no connections from here => delete
+				delete cargo[last_catg_index];
+				cargo[last_catg_index] = NULL;
+			}
+			else {
+				// replace the contents
+				warray->clear();
+				for(ware_t const& ware : new_warray) {
+					warray->append( ware );
 				}
 			}
 
-			// replace the array
-			delete cargo[last_catg_index];
-			cargo[last_catg_index] = new_warray;
-
 			// if something left
 			// re-route goods to adapt to changes in world layout,
 			// remove all goods whose destination was removed from the map
@@ -1136,24 +1144,57 @@ bool haltestelle_t::connect_factory(fabrik_t *fab)
 
 void haltestelle_t::verbinde_fabriken()
 {
-	// unlink all
+	factory_relink_pending = false;
+
+	static vector_tpl<fabrik_t *> old_fab_list;
+	old_fab_list.clear();
 	for(fabrik_t* const f : fab_list) {
-		f->unlink_halt(self);
+		old_fab_list.append( f );
 	}
 	fab_list.clear();
 
-	// then reconnect
+	// collect the factories in reach
 	for(tile_t const& i : tiles) {
 		koord const p = i.grund->get_pos().get_2d();
 
 		uint16 const cov = welt->get_settings().get_station_coverage();
 		for(fabrik_t* const fab : fabrik_t::sind_da_welche(p - koord(cov, cov), p + koord(cov, cov))) {
-			if (connect_factory(fab)) {
-				// also connect the factory to this halt
-				fab->link_halt(self);
-			}
+			connect_factory(fab);
+		}
+	}
+
+	// unlink only the factories out of reach now ...
+	for(fabrik_t* const f : old_fab_list) {
+		if(  !fab_list.is_contained( f )  ) {
+			f->unlink_halt(self);
 		}
 	}
+	// ... and (re)link the others, which also sorts this halt by its new distance
+	for(fabrik_t* const f : fab_list) {
+		f->link_halt(self);
+	}
+}
+
+
+void haltestelle_t::request_factory_relink()
+{
+	if(  !factory_relink_pending  ) {
+		factory_relink_pending = true;
+		pending_factory_relinks.append( self );
+	}
+}
+
+
+void haltestelle_t::relink_pending_factories()
+{
+	for(  uint32 i = 0;  i < pending_factory_relinks.get_count();  i++  ) {
+		// the halt may have been removed meanwhile
+		const halthandle_t halt = pending_factory_relinks[i];
+		if(  halt.is_bound()  &&  halt->factory_relink_pending  ) {
+			halt->verbinde_fabriken();
+		}
+	}
+	pending_factory_relinks.clear();
 }
 
 
@@ -1240,8 +1281,9 @@ sint32 haltestelle_t::rebuild_connections()
 		}
 
 		// find the index from which to start processing
+		const minivec_tpl<halthandle_t> &schedule_halts = schedule->get_halts( owner );
 		uint8 start_index = 0;
-		while(  start_index < schedule->get_count()  &&  get_halt( schedule->entries[start_index].pos, owner ) != self  ) {
+		while(  start_index < schedule->get_count()  &&  schedule_halts[start_index] != self  ) {
 			++start_index;
 		}
 		++start_index; // the next index after self halt; it's okay to be out-of-range
@@ -1267,7 +1309,7 @@ sint32 haltestelle_t::rebuild_connections()
 		uint16 aggregate_weight = WEIGHT_WAIT;
 		for(  uint8 j=0;  j<schedule->get_count();  ++j  ) {
 
-			halthandle_t current_halt = get_halt(schedule->entries[(start_index+j)%schedule->get_count()].pos, owner );
+			halthandle_t current_halt = schedule_halts[(start_index+j)%schedule->get_count()];
 			if(  !current_halt.is_bound()  ) {
 				// ignore way points
 				continue;
@@ -1518,6 +1560,7 @@ uint8 haltestelle_t::last_search_ware_catg_idx = 255;
  */
 int haltestelle_t::search_route( const halthandle_t *const start_halts, const uint16 start_halt_count, const bool no_routing_over_overcrowding, ware_t &ware, ware_t *const return_ware )
 {
+	PERF_SCOPE(PERF_SEARCH_ROUTE);
 	const uint8 ware_catg_idx = ware.get_desc()->get_catg_index();
 	const uint8 ware_idx = ware.get_desc()->get_index();
 
@@ -2513,6 +2556,7 @@ void haltestelle_t::change_owner( player_t *player )
 
 	// now finally change owner
 	owner = player;
+	layout_changed();
 	rebuild_connections();
 	rebuild_linked_connections();
 	rebuild_connected_components();
@@ -3218,7 +3262,7 @@ bool haltestelle_t::add_grund(grund_t *gr, bool relink_factories)
 
 	// since suddenly other factories may be connect to us too
 	if (relink_factories) {
-		verbinde_fabriken();
+		request_factory_relink();
 	}
 
 	// check if we have to register line(s) and/or lineless convoy(s) which serve this halt
@@ -3339,19 +3383,44 @@ bool haltestelle_t::rem_grund(grund_t *gr)
 			pl->get_kartenboden()->set_flag(grund_t::dirty);
 		}
 
+		// the remaining tiles which may still cover some of the removed catchment
+		const koord pos = gr->get_pos().get_2d();
 		uint16 const cov = welt->get_settings().get_station_coverage();
+		static vector_tpl<koord> near_tiles;
+		near_tiles.clear();
+		for(tile_t const& t : tiles) {
+			const koord p = t.grund->get_pos().get_2d();
+			if(  abs(p.x - pos.x) <= 2*cov  &&  abs(p.y - pos.y) <= 2*cov  ) {
+				near_tiles.append( p );
+			}
+		}
+
 		for (int y = -cov; y <= cov; y++) {
 			for (int x = -cov; x <= cov; x++) {
-				planquadrat_t *pl = welt->access( gr->get_pos().get_2d()+koord(x,y) );
+				const koord p = pos+koord(x,y);
+				planquadrat_t *pl = welt->access( p );
 				if(pl) {
-					pl->remove_from_haltlist(self);
+					bool still_covered = false;
+					for(koord const& t : near_tiles) {
+						if(  abs(t.x - p.x) <= cov  &&  abs(t.y - p.y) <= cov  ) {
+							still_covered = true;
+							break;
+						}
+					}
+					if(  still_covered  ) {
+						// the nearest tile may have changed
+						pl->add_to_haltlist(self);
+					}
+					else {
+						pl->remove_from_haltlist(self, false);
+					}
 					pl->get_kartenboden()->set_flag(grund_t::dirty);
 				}
 			}
 		}
 
 		// factory reach may have been changed ...
-		verbinde_fabriken();
+		request_factory_relink();
 	}
 
 	// needs to be done, if this was a dock
@@ -102,6 +102,9 @@ private:
 	 */
 	static inthashtable_tpl<sint32,halthandle_t> *all_koords;
 
+	/// see get_layout_version()
+	static uint32 layout_version;
+
 	vector_tpl<halthandle_t>* halt_served_this_step;
 
 	/**
@@ -176,6 +179,14 @@ public:
 	 */
 	static halthandle_t get_halt(const koord3d pos, const player_t *player );
 
+	/**
+	 * Changes whenever the result of get_halt() may change for any position,
+	 * i.e. a tile gets or loses a halt, a halt changes owner or a catchment changes.
+	 * Used to validate cached results, see schedule_t::get_halts().
+	 */
+	static uint32 get_layout_version() { return layout_version; }
+	static void layout_changed() { layout_version++; }
+
 	static const vector_tpl<halthandle_t>& get_alle_haltestellen() { return alle_haltestellen; }
 
 	/**
@@ -310,6 +321,13 @@ private:
 	 */
 	slist_tpl<fabrik_t *> fab_list;
 
+	/// the halts which wait for verbinde_fabriken(), see relink_pending_factories()
+	static vector_tpl<halthandle_t> pending_factory_relinks;
+	bool factory_relink_pending;
+
+	/// verbinde_fabriken() at the next relink_pending_factories(), only once however often requested
+	void request_factory_relink();
+
 	player_t *owner;
 	static karte_ptr_t welt;
 
@@ -389,6 +407,14 @@ public:
 	 */
 	void verbinde_fabriken();
 
+	/**
+	 * Catchment changes from building and removing stops only request to relink
+	 * the factories of the halt. This does it for all halts with such requests,
+	 * at the start of each step. Saving leaves them pending, since
+	 * finish_rd() relinks all halts after loading anyway.
+	 */
+	static void relink_pending_factories();
+
 	/**
 	 * Connects factory to this halt if not already connected and
 	 * reachability check for oil rigs passed.
@@ -17,6 +17,7 @@
 
 #include "world/simworld.h"
 #include "display/simview.h"
+#include "utils/perf_timer.h"
 
 #include "ground/wasser.h"
 
@@ -77,14 +78,21 @@ void intr_refresh_display(bool dirty)
 {
 	wasser_t::prepare_for_refresh();
 	dr_prepare_flush();
-	main_view->display( dirty );
-	if(  env_t::player_finance_display_account  ) {
-		win_display_flush( (double)world()->get_active_player()->get_finance()->get_account_balance()/100.0 );
+	{
+		PERF_SCOPE(PERF_DISPLAY_WORLD);
+		main_view->display( dirty );
 	}
-	else {
-		win_display_flush( (double)world()->get_active_player()->get_finance()->get_netwealth()/100.0 );
+	{
+		PERF_SCOPE(PERF_DISPLAY_WINDOWS);
+		if(  env_t::player_finance_display_account  ) {
+			win_display_flush( (double)world()->get_active_player()->get_finance()->get_account_balance()/100.0 );
+		}
+		else {
+			win_display_flush( (double)world()->get_active_player()->get_finance()->get_netwealth()/100.0 );
+		}
 	}
 	// with a switch statement more types could be supported ...
+	PERF_SCOPE(PERF_DISPLAY_FLUSH);
 	dr_flush();
 }
 
@@ -108,6 +116,8 @@ void interrupt_check(const char* caller_info)
 
 		const sint32 diff = (( (sint32)now - (sint32)last_time)*world()->get_time_multiplier())/16;
 		if(  diff>0  ) {
+			// not part of the step timings around this check
+			PERF_PAUSE();
 			enabled = false;
 			last_time = now;
 			if (!world()->is_fast_forward()) {
@@ -148,6 +158,12 @@ void intr_enable()
 }
 
 
+bool intr_is_enabled()
+{
+	return enabled;
+}
+
+
 char const *tick_to_string( uint32 ticks, bool only_DDMMHHMM )
 {
 	static sint32 tage_per_month[12]={31,28,31,30,31,30,31,31,30,31,30,31};
@@ -88,6 +88,7 @@
 #include "sound/sound.h"
 
 #include "utils/cbuffer.h"
+#include "utils/perf_timer.h"
 #include "utils/simrandom.h"
 #include "utils/unicode.h"
 
@@ -542,6 +543,7 @@ static bool set_pakdir( const char *chkdir )
 int simu_main(int argc, char** argv)
 {
 	std::set_new_handler(sim_new_handler);
+	perf_timer_t::set_main_thread();
 
 	args_t args(argc, argv);
 #ifdef DEBUG
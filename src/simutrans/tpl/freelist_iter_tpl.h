@@ -122,6 +122,34 @@ public:
 		}
 	}
 
+	/**
+	 * Like sync_step(), but steps only every @p parts-th slot, starting with slot @p part.
+	 * An object keeps its slot, so it is stepped every @p parts-th call, if @p part cycles.
+	 */
+	void sync_step_part(uint32 delta_t, uint32 part, uint32 parts)
+	{
+		size_t base = 0;
+		chunklist_node_t* c_list = chunk_list;
+		while (c_list) {
+			T  *p = (T *)(((char *)c_list)+sizeof(chunklist_node_t));
+			for (size_t i = (part + parts - base % parts) % parts; i < new_chuck_size; i += parts) {
+				if (c_list->allocated_mask.test(i)) {
+					if (sync_result result = p[i].sync_step(delta_t)) {
+						c_list->allocated_mask.set(i, false);
+						if (result == SYNC_DELETE) {
+							delete (p+i);
+							if (nodecount == 0) {
+								return;
+							}
+						}
+					}
+				}
+			}
+			base += new_chuck_size;
+			c_list = c_list->chunk_next;
+		}
+	}
+
 	// switch on off sync handling
 	void add_sync(T* p) { change_obj((char*)p,true); };
 	void remove_sync(T* p) { change_obj((char*)p,false); };
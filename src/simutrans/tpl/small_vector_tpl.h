@@ -0,0 +1,70 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef TPL_SMALL_VECTOR_TPL_H
+#define TPL_SMALL_VECTOR_TPL_H
+
+
+#include "vector_tpl.h"
+
+
+/**
+ * A vector_tpl, which keeps up to N elements inside the object itself.
+ * Meant for local scratch lists, which are usually short:
+ * they need no memory from the heap until they grow beyond N.
+ * It can be passed to everything that takes a vector_tpl.
+ * @note Never swap() it with another vector, its memory cannot move.
+ */
+template<class T, uint32 N>
+class small_vector_tpl : public vector_tpl<T>
+{
+private:
+	/// hands out the inline buffer if it is free, else memory from the heap
+	class inline_allocator_t : public vector_allocator_t
+	{
+	private:
+		alignas(T) char buffer[N * sizeof(T)];
+		bool in_use;
+
+	public:
+		inline_allocator_t() : in_use(false) {}
+
+		void *allocate(size_t bytes) OVERRIDE
+		{
+			if(  !in_use  &&  bytes <= sizeof(buffer)  ) {
+				in_use = true;
+				return buffer;
+			}
+			return ::operator new(bytes);
+		}
+
+		void deallocate(void *p, size_t) OVERRIDE
+		{
+			if(  p == buffer  ) {
+				in_use = false;
+			}
+			else {
+				::operator delete(p);
+			}
+		}
+	};
+
+	inline_allocator_t inline_alloc;
+
+public:
+	small_vector_tpl() : vector_tpl<T>()
+	{
+		this->set_allocator( &inline_alloc );
+		this->reserve( N );
+	}
+
+	small_vector_tpl(const small_vector_tpl &) = delete;
+	small_vector_tpl& operator=(const small_vector_tpl &) = delete;
+
+	// the memory must be returned while inline_alloc still exists
+	~small_vector_tpl() { this->free_data(); }
+};
+
+#endif
@@ -0,0 +1,147 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef TPL_SPATIAL_INDEX_TPL_H
+#define TPL_SPATIAL_INDEX_TPL_H
+
+
+#include "vector_tpl.h"
+#include "../dataobj/koord.h"
+#include "../simtypes.h"
+
+
+/**
+ * A uniform grid over the map, answering "which objects cover this area"
+ * without iterating over all objects or all tiles.
+ * Every object is stored with its bounding rectangle (both corners inclusive)
+ * in each grid cell the rectangle touches.
+ * The order of the results depends on the insertion history;
+ * callers that need a deterministic order must sort them.
+ */
+template<class T> class spatial_index_tpl
+{
+private:
+	struct entry_t
+	{
+		T obj;
+		koord min, max;
+	};
+
+	enum { CELL_SHIFT = 5 }; // 32x32 tiles per cell
+
+	vector_tpl<entry_t> *cells;
+	sint16 cells_x, cells_y;
+
+	/// clips the rectangle to the map, returns false if nothing is left
+	bool clip(koord &min, koord &max) const
+	{
+		min.clip_min( koord(0,0) );
+		max.clip_max( koord( (cells_x<<CELL_SHIFT)-1, (cells_y<<CELL_SHIFT)-1 ) );
+		return cells  &&  min.x <= max.x  &&  min.y <= max.y;
+	}
+
+	vector_tpl<entry_t> &get_cell(sint16 cx, sint16 cy) const { return cells[cy*cells_x + cx]; }
+
+public:
+	spatial_index_tpl() : cells(NULL), cells_x(0), cells_y(0) {}
+
+	~spatial_index_tpl() { delete [] cells; }
+
+	/// empties the index and sizes it for a map of this size
+	void init(koord size)
+	{
+		delete [] cells;
+		cells_x = (size.x + (1<<CELL_SHIFT) - 1) >> CELL_SHIFT;
+		cells_y = (size.y + (1<<CELL_SHIFT) - 1) >> CELL_SHIFT;
+		cells = (cells_x > 0  &&  cells_y > 0) ? new vector_tpl<entry_t>[cells_x*cells_y] : NULL;
+	}
+
+	void clear()
+	{
+		delete [] cells;
+		cells = NULL;
+		cells_x = cells_y = 0;
+	}
+
+	/// does nothing before init() was called
+	void add(T obj, koord min, koord max)
+	{
+		if(  !clip( min, max )  ) {
+			return;
+		}
+		entry_t e;
+		e.obj = obj;
+		e.min = min;
+		e.max = max;
+		for(  sint16 cy = min.y >> CELL_SHIFT;  cy <= max.y >> CELL_SHIFT;  cy++  ) {
+			for(  sint16 cx = min.x >> CELL_SHIFT;  cx <= max.x >> CELL_SHIFT;  cx++  ) {
+				get_cell( cx, cy ).append( e );
+			}
+		}
+	}
+
+	/**
+	 * @param min,max must be the rectangle the object was added with
+	 * @return false, if the object was not found
+	 */
+	bool remove(T obj, koord min, koord max)
+	{
+		if(  !clip( min, max )  ) {
+			return false;
+		}
+		bool found = false;
+		for(  sint16 cy = min.y >> CELL_SHIFT;  cy <= max.y >> CELL_SHIFT;  cy++  ) {
+			for(  sint16 cx = min.x >> CELL_SHIFT;  cx <= max.x >> CELL_SHIFT;  cx++  ) {
+				vector_tpl<entry_t> &cell = get_cell( cx, cy );
+				for(  uint32 i = 0;  i < cell.get_count();  i++  ) {
+					if(  cell[i].obj == obj  ) {
+						// order does not matter
+						cell[i] = cell.back();
+						cell.pop_back();
+						found = true;
+						break;
+					}
+				}
+			}
+		}
+		return found;
+	}
+
+	/// moves an object to a new rectangle; objects not in the index stay out of it
+	void update(T obj, koord old_min, koord old_max, koord new_min, koord new_max)
+	{
+		if(  remove( obj, old_min, old_max )  ) {
+			add( obj, new_min, new_max );
+		}
+	}
+
+	/**
+	 * Appends all objects whose rectangle intersects min..max (inclusive) to result.
+	 * Each object is reported once.
+	 */
+	void find_area(koord min, koord max, vector_tpl<T> &result) const
+	{
+		if(  !clip( min, max )  ) {
+			return;
+		}
+		for(  sint16 cy = min.y >> CELL_SHIFT;  cy <= max.y >> CELL_SHIFT;  cy++  ) {
+			for(  sint16 cx = min.x >> CELL_SHIFT;  cx <= max.x >> CELL_SHIFT;  cx++  ) {
+				for(  entry_t const& e : get_cell( cx, cy )  ) {
+					if(  e.max.x < min.x  ||  e.min.x > max.x  ||  e.max.y < min.y  ||  e.min.y > max.y  ) {
+						continue;
+					}
+					// only report in the first cell of the intersection
+					const sint16 first_x = e.min.x > min.x ? e.min.x : min.x;
+					const sint16 first_y = e.min.y > min.y ? e.min.y : min.y;
+					if(  (first_x >> CELL_SHIFT) == cx  &&  (first_y >> CELL_SHIFT) == cy  ) {
+						result.append( e.obj );
+					}
+				}
+			}
+		}
+	}
+};
+
+#endif
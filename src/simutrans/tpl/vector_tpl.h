@@ -7,7 +7,9 @@
 #define TPL_VECTOR_TPL_H
 
 
+#include <new>
 #include <typeinfo>
+#include <utility>
 
 #include "../macros.h"
 #include "../simtypes.h"
@@ -17,6 +19,20 @@ template<class T> class vector_tpl;
 template<class T> inline void swap(vector_tpl<T>& a, vector_tpl<T>& b);
 
 
+/**
+ * Provides the memory of a vector_tpl instead of the heap.
+ * The allocator must live longer than all vectors using it.
+ */
+class vector_allocator_t
+{
+public:
+	virtual ~vector_allocator_t() {}
+
+	virtual void *allocate(size_t bytes) = 0;
+	virtual void deallocate(void *p, size_t bytes) = 0;
+};
+
+
 /** A template class for a simple vector type */
 template<class T>
 class vector_tpl
@@ -29,26 +45,61 @@ public:
 	vector_tpl() :
 		data(NULL),
 		cap(0),
-		count(0)
+		count(0),
+		alloc(NULL)
 	{}
 
 	explicit vector_tpl(const uint32 cap) :
-		data(cap > 0 ? new T[cap] : NULL),
-		cap(cap),
-		count(0)
-	{}
+		data(NULL),
+		cap(0),
+		count(0),
+		alloc(NULL)
+	{
+		reserve(cap);
+	}
+
+	/// @param alloc provides the memory, NULL for the heap
+	vector_tpl(const uint32 cap, vector_allocator_t *alloc) :
+		data(NULL),
+		cap(0),
+		count(0),
+		alloc(alloc)
+	{
+		reserve(cap);
+	}
 
 	vector_tpl(const vector_tpl& copy_from) :
-		data( copy_from.cap > 0 ? new T[ copy_from.cap ] : 0 ),
-		cap( copy_from.cap ),
-		count( copy_from.count )
+		data(NULL),
+		cap(0),
+		count(0),
+		alloc(NULL)
 	{
+		reserve( copy_from.cap );
+		count = copy_from.count;
 		for( uint32 i = 0; i < count; i++ ) {
 			data[i] = copy_from.data[i];
 		}
 	}
 
-	~vector_tpl() { delete[] data; }
+	/// Takes over the memory of @p move_from if it is on the heap, else moves the elements
+	vector_tpl(vector_tpl&& move_from) :
+		data(NULL),
+		cap(0),
+		count(0),
+		alloc(NULL)
+	{
+		take_from( move_from );
+	}
+
+	~vector_tpl() { free_data(); }
+
+	vector_tpl& operator=( vector_tpl&& move_from )
+	{
+		if(  this != &move_from  ) {
+			take_from( move_from );
+		}
+		return *this;
+	}
 
 	/** sets the vector to empty */
 	void clear() { count = 0; }
@@ -61,15 +112,15 @@ public:
 	{
 		if (new_capacity <= cap) return; // do nothing
 
-		T *new_data = new T[new_capacity];
-		if (cap>0) {
-			for (uint32 i = 0; i < count; i++) {
-				new_data[i] = data[i];
-			}
-			delete [] data;
+		T *new_data = allocate_data(new_capacity);
+		for (uint32 i = 0; i < count; i++) {
+			new_data[i] = std::move(data[i]);
 		}
-		cap  = new_capacity;
-		data = new_data;
+		const uint32 new_count = count;
+		free_data();
+		cap   = new_capacity;
+		count = new_count;
+		data  = new_data;
 	}
 
 	/**
@@ -109,6 +160,25 @@ public:
 		data[count++] = elem;
 	}
 
+	void append(T&& elem)
+	{
+		if(  count == cap  ) {
+			reserve(cap == 0 ? 1 : cap * 2);
+		}
+		data[count++] = std::move(elem);
+	}
+
+	/** Appends a new element made from @p args and returns it */
+	template<class... Args>
+	T& emplace_back(Args&&... args)
+	{
+		if(  count == cap  ) {
+			reserve(cap == 0 ? 1 : cap * 2);
+		}
+		data[count] = T(std::forward<Args>(args)...);
+		return data[count++];
+	}
+
 	/**
 	 * Checks if element is contained. Appends only new elements.
 	 * extend vector if necessary
@@ -130,7 +200,7 @@ public:
 				reserve(cap == 0 ? 1 : cap * 2);
 			}
 			for (uint i = count; i > pos; i--) {
-				data[i] = data[i - 1];
+				data[i] = std::move(data[i - 1]);
 			}
 			data[pos] = elem;
 			count++;
@@ -224,7 +294,7 @@ public:
 	{
 		assert(pos<count);
 		for (uint i = pos; i < count - 1; i++) {
-			data[i] = data[i + 1];
+			data[i] = std::move(data[i + 1]);
 		}
 		count--;
 		return true;
@@ -272,10 +342,71 @@ public:
 
 	bool empty() const { return count == 0; }
 
+protected:
+	/**
+	 * Memory comes from @p alloc from now on (NULL for the heap).
+	 * Only call on vectors without memory.
+	 */
+	void set_allocator(vector_allocator_t *a)
+	{
+		assert(data == NULL);
+		alloc = a;
+	}
+
+	/// Destroys all elements and returns the memory, the vector can be used afterwards
+	void free_data()
+	{
+		if(  data  ) {
+			for(  uint32 i = 0;  i < cap;  i++  ) {
+				data[i].~T();
+			}
+			if(  alloc  ) {
+				alloc->deallocate(data, cap * sizeof(T));
+			}
+			else {
+				::operator delete(data);
+			}
+		}
+		data  = NULL;
+		cap   = 0;
+		count = 0;
+	}
+
 private:
 	T* data;
 	uint32 cap;   ///< Capacity
 	uint32 count; ///< Number of elements in vector
+	vector_allocator_t *alloc; ///< NULL for the heap
+
+	/// all elements are default constructed, like new T[n] would do
+	T *allocate_data(uint32 n)
+	{
+		T *new_data = static_cast<T *>( alloc ? alloc->allocate(n * sizeof(T)) : ::operator new(n * sizeof(T)) );
+		for(  uint32 i = 0;  i < n;  i++  ) {
+			new (new_data + i) T;
+		}
+		return new_data;
+	}
+
+	void take_from(vector_tpl& other)
+	{
+		if(  alloc == NULL  &&  other.alloc == NULL  ) {
+			free_data();
+			sim::swap(data,  other.data);
+			sim::swap(cap,   other.cap);
+			sim::swap(count, other.count);
+		}
+		else {
+			// memory cannot change owners
+			clear();
+			reserve(other.count);
+			for(  uint32 i = 0;  i < other.count;  i++  ) {
+				data[i] = std::move(other.data[i]);
+			}
+			count = other.count;
+			other.clear();
+		}
+	}
 
 	vector_tpl& operator=( vector_tpl const& other ) {
 		vector_tpl tmp(other);
@@ -288,11 +419,13 @@ private:
 };
 
 
+/// the memory is exchanged together with its allocator, so never swap a small_vector_tpl
 template<class T> void swap(vector_tpl<T>& a, vector_tpl<T>& b)
 {
 	sim::swap(a.data,  b.data);
 	sim::swap(a.cap,   b.cap);
 	sim::swap(a.count, b.count);
+	sim::swap(a.alloc, b.alloc);
 }
 
 /**
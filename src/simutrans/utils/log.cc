@@ -43,6 +43,55 @@
 #define  LOG_TAG    "com.simutrans"
 #endif
 
+#if defined(MULTI_THREAD)  &&  !defined(MAKEOBJ)  &&  !defined(NETTOOL)
+#define LOG_ASYNC
+#include <atomic>
+#include "simthread.h"
+
+// longer records are written directly
+#define LOG_RECORD_SIZE (512)
+
+// number of queued records, must be a power of two
+#define LOG_QUEUE_SIZE (1024)
+
+// debug messages and warnings per second, each level has its own limit
+#define LOG_RATE_LIMIT (1000)
+
+// the writer thread sleeps this long when the queue is empty
+#define LOG_WRITER_SLEEP_MS (5)
+
+
+struct log_t::async_t
+{
+	/// sequence is the position in the queue plus one when the text is ready to be written
+	struct record_t
+	{
+		std::atomic<uint32> sequence;
+		char text[LOG_RECORD_SIZE];
+	};
+
+	/// the limit of one level
+	struct rate_t
+	{
+		std::atomic<uint32> second;
+		std::atomic<uint32> count;
+		std::atomic<uint32> suppressed;
+		/// caller of the last dropped record, for the report
+		std::atomic<const char *> last_who;
+	};
+
+	record_t records[LOG_QUEUE_SIZE];
+	std::atomic<uint32> head; ///< next record to fill
+	uint32 tail;              ///< next record to write, only changed with write_mutex locked
+
+	rate_t rates[LEVEL_DEBUG+1];
+
+	pthread_t writer;
+	pthread_mutex_t write_mutex;
+	std::atomic<bool> stop;
+};
+#endif
+
 /**
  * writes a debug message into the log.
  */
@@ -51,8 +100,11 @@ void log_t::debug(const char *who, const char *format, ...)
 	if(log_debug  &&  debuglevel >= log_t::LEVEL_DEBUG) {
 		va_list argptr;
 		va_start(argptr, format);
+		const bool queued = write_async( "Debug", who, format, argptr, LEVEL_DEBUG );
+		va_end(argptr);
 
-		if( log ) {                           /* only log when a log */
+		va_start(argptr, format);
+		if( log  &&  !queued ) {              /* only log when a log */
 			fprintf(log ,"Debug: %s:\t",who); /* is already open */
 			vfprintf(log, format, argptr);
 			fprintf(log,"\n");
@@ -64,7 +116,7 @@ void log_t::debug(const char *who, const char *format, ...)
 		va_end(argptr);
 
 		va_start(argptr, format);
-		if( tee ) {                           /* only log when a log */
+		if( tee  &&  !queued ) {              /* only log when a log */
 			fprintf(tee, "Debug: %s:\t",who); /* is already open */
 			vfprintf(tee, format, argptr);
 			fprintf(tee,"\n");
@@ -101,8 +153,11 @@ void log_t::message(const char *who, const char *format, ...)
 	if(debuglevel >= log_t::LEVEL_MSG) {
 		va_list argptr;
 		va_start(argptr, format);
+		const bool queued = write_async( "Message", who, format, argptr, LEVEL_MSG );
+		va_end(argptr);
 
-		if( log ) {                             /* only log when a log */
+		va_start(argptr, format);
+		if( log  &&  !queued ) {                /* only log when a log */
 			fprintf(log ,"Message: %s:\t",who); /* is already open */
 			vfprintf(log, format, argptr);
 			fprintf(log,"\n");
@@ -114,7 +169,7 @@ void log_t::message(const char *who, const char *format, ...)
 		va_end(argptr);
 
 		va_start(argptr, format);
-		if( tee ) {                             /* only log when a log */
+		if( tee  &&  !queued ) {                /* only log when a log */
 			fprintf(tee, "Message: %s:\t",who); /* is already open */
 			vfprintf(tee, format, argptr);
 			fprintf(tee,"\n");
@@ -151,8 +206,11 @@ void log_t::warning(const char *who, const char *format, ...)
 	if(debuglevel >= log_t::LEVEL_WARN) {
 		va_list argptr;
 		va_start(argptr, format);
+		const bool queued = write_async( "Warning", who, format, argptr, LEVEL_WARN );
+		va_end(argptr);
 
-		if( log ) {                             /* only log when a log */
+		va_start(argptr, format);
+		if( log  &&  !queued ) {                /* only log when a log */
 			fprintf(log ,"Warning: %s:\t",who); /* is already open */
 			vfprintf(log, format, argptr);
 			fprintf(log,"\n");
@@ -164,7 +222,7 @@ void log_t::warning(const char *who, const char *format, ...)
 		va_end(argptr);
 
 		va_start(argptr, format);
-		if( tee ) {                             /* only log when a log */
+		if( tee  &&  !queued ) {                /* only log when a log */
 			fprintf(tee, "Warning: %s:\t",who); /* is already open */
 			vfprintf(tee, format, argptr);
 			fprintf(tee,"\n");
@@ -199,6 +257,13 @@ void log_t::warning(const char *who, const char *format, ...)
 void log_t::error(const char *who, const char *format, ...)
 {
 	if(debuglevel >= log_t::LEVEL_ERROR) {
+#ifdef LOG_ASYNC
+		// errors are written at once, after all queued records
+		if(  async  ) {
+			pthread_mutex_lock( &async->write_mutex );
+			write_queued( true );
+		}
+#endif
 		va_list argptr;
 		va_start(argptr, format);
 
@@ -226,6 +291,11 @@ void log_t::error(const char *who, const char *format, ...)
 			fprintf(tee ,"https://forum.simutrans.com\n");
 		}
 		va_end(argptr);
+#ifdef LOG_ASYNC
+		if(  async  ) {
+			pthread_mutex_unlock( &async->write_mutex );
+		}
+#endif
 
 #ifdef SYSLOG
 		va_start( argptr, format );
@@ -278,6 +348,15 @@ void log_t::fatal(const char* who, const char* format, ...)
 
 void log_t::custom_fatal(char *buffer)
 {
+#ifdef LOG_ASYNC
+	if(  async  ) {
+		// the records before are usually needed to understand the error
+		pthread_mutex_lock( &async->write_mutex );
+		write_queued( true );
+		pthread_mutex_unlock( &async->write_mutex );
+	}
+#endif
+
 	if(  log  ) {
 		fputs( buffer, log );
 		if (  force_flush  ) {
@@ -351,6 +430,12 @@ void log_t::vmessage(const char *what, const char *who, const char *format, va_l
 	if(debuglevel >= LEVEL_ERROR) {
 		va_list args2;
 		va_copy(args2, args);
+		if(  write_async( what, who, format, args2, LEVEL_MSG )  ) {
+			va_end(args2);
+			return;
+		}
+		va_end(args2);
+		va_copy(args2, args);
 
 		if( log ) {                               /* only log when a log */
 			fprintf(log ,"%s: %s:\t", what, who); /* is already open */
@@ -381,6 +466,7 @@ log_t::log_t( const char *logfilename, bool force_flush, bool log_debug, bool lo
 #ifdef SYSLOG
 	, syslog(false)
 #endif
+	, async(NULL)
 {
 	if(logfilename == NULL) {
 		log = NULL;                       /* not a log */
@@ -440,6 +526,7 @@ log_t::log_t( const char *logfilename, bool force_flush, bool log_debug, bool lo
 void log_t::close()
 {
 	message("log_t::~log_t","stop logging, closing log file");
+	set_async( false );
 
 	if( log ) {
 		fclose(log);
@@ -451,7 +538,237 @@ void log_t::close()
 // close all logs during cleanup
 log_t::~log_t()
 {
+	set_async( false );
 	if( log ) {
 		close();
 	}
 }
+
+
+bool log_t::write_async(const char *what, const char *who, const char *format, va_list args, level_t level, const char *suffix)
+{
+#ifdef LOG_ASYNC
+	if(  async == NULL  ) {
+		return false;
+	}
+	if(  is_rate_limited( level, who )  ) {
+		return true;
+	}
+
+	va_list args2;
+	va_copy( args2, args );
+
+	char text[LOG_RECORD_SIZE];
+	int len = snprintf( text, LOG_RECORD_SIZE, "%s: %s:\t", what, who );
+	if(  len >= 0  &&  len < LOG_RECORD_SIZE  ) {
+		const int n = vsnprintf( text + len, LOG_RECORD_SIZE - len, format, args );
+		len = n < 0 ? -1 : len + n;
+	}
+	if(  len >= 0  &&  len < LOG_RECORD_SIZE  ) {
+		const int n = snprintf( text + len, LOG_RECORD_SIZE - len, "\n%s", suffix ? suffix : "" );
+		len = n < 0 ? -1 : len + n;
+	}
+	const bool fits = len >= 0  &&  len < LOG_RECORD_SIZE;
+
+	if(  !fits  ||  !push_record( text )  ) {
+		// too long or the queue is full: write it directly after the queued ones
+		pthread_mutex_lock( &async->write_mutex );
+		write_queued( true );
+		if(  fits  ) {
+			write_text( text );
+		}
+		else {
+			va_list args3;
+			va_copy( args3, args2 );
+			if(  log  ) {
+				fprintf( log, "%s: %s:\t", what, who );
+				vfprintf( log, format, args2 );
+				fprintf( log, "\n%s", suffix ? suffix : "" );
+			}
+			if(  tee  ) {
+				fprintf( tee, "%s: %s:\t", what, who );
+				vfprintf( tee, format, args3 );
+				fprintf( tee, "\n%s", suffix ? suffix : "" );
+			}
+			va_end( args3 );
+		}
+		if(  log  &&  force_flush  ) {
+			fflush( log );
+		}
+		pthread_mutex_unlock( &async->write_mutex );
+	}
+	va_end( args2 );
+	return true;
+#else
+	(void)what; (void)who; (void)format; (void)args; (void)level; (void)suffix;
+	return false;
+#endif
+}
+
+
+bool log_t::is_rate_limited(level_t level, const char *who)
+{
+#ifdef LOG_ASYNC
+	if(  level != LEVEL_DEBUG  &&  level != LEVEL_WARN  ) {
+		// messages are needed to follow what happened, e.g. while loading
+		return false;
+	}
+	async_t::rate_t &rate = async->rates[level];
+	const uint32 second = dr_time() / 1000;
+	if(  rate.second.load( std::memory_order_relaxed ) != second  ) {
+		// new second: report what was dropped in the last one of this level
+		rate.second.store( second, std::memory_order_relaxed );
+		rate.count.store( 0, std::memory_order_relaxed );
+		if(  const uint32 suppressed = rate.suppressed.exchange( 0 )  ) {
+			char text[LOG_RECORD_SIZE];
+			snprintf( text, LOG_RECORD_SIZE, "Warning: log_t:\t%u %s records suppressed before (more than %d per second), the last from %s\n",
+				suppressed, level == LEVEL_DEBUG ? "debug" : "warning", LOG_RATE_LIMIT, rate.last_who.load() );
+			push_record( text );
+		}
+	}
+	if(  rate.count.fetch_add( 1, std::memory_order_relaxed ) >= LOG_RATE_LIMIT  ) {
+		rate.last_who.store( who );
+		rate.suppressed.fetch_add( 1 );
+		return true;
+	}
+#else
+	(void)level; (void)who;
+#endif
+	return false;
+}
+
+
+bool log_t::push_record(const char *text)
+{
+#ifdef LOG_ASYNC
+	// bounded multi-producer queue: claim a record by advancing head, then publish it by its sequence
+	uint32 pos = async->head.load( std::memory_order_relaxed );
+	for(;;) {
+		async_t::record_t &r = async->records[ pos & (LOG_QUEUE_SIZE-1) ];
+		const sint32 diff = (sint32)(r.sequence.load( std::memory_order_acquire ) - pos);
+		if(  diff == 0  ) {
+			if(  async->head.compare_exchange_weak( pos, pos+1, std::memory_order_relaxed )  ) {
+				strcpy( r.text, text );
+				r.sequence.store( pos+1, std::memory_order_release );
+				return true;
+			}
+		}
+		else if(  diff < 0  ) {
+			// full
+			return false;
+		}
+		else {
+			pos = async->head.load( std::memory_order_relaxed );
+		}
+	}
+#else
+	(void)text;
+	return false;
+#endif
+}
+
+
+void log_t::write_text(const char *text)
+{
+	if(  log  ) {
+		fputs( text, log );
+	}
+	if(  tee  ) {
+		fputs( text, tee );
+	}
+}
+
+
+uint32 log_t::write_queued(bool all)
+{
+	uint32 written = 0;
+#ifdef LOG_ASYNC
+	const uint32 head = async->head.load();
+	for(;;) {
+		async_t::record_t &r = async->records[ async->tail & (LOG_QUEUE_SIZE-1) ];
+		if(  r.sequence.load( std::memory_order_acquire ) != async->tail+1  ) {
+			if(  all  &&  (sint32)(head - async->tail) > 0  ) {
+				// claimed before we started but still being filled, wait since the caller wants to write after it
+				dr_sleep( 0 );
+				continue;
+			}
+			break;
+		}
+		write_text( r.text );
+		r.sequence.store( async->tail + LOG_QUEUE_SIZE, std::memory_order_release );
+		async->tail++;
+		written++;
+	}
+	if(  written  &&  log  &&  force_flush  ) {
+		fflush( log );
+	}
+#else
+	(void)all;
+#endif
+	return written;
+}
+
+
+void *log_t::writer_thread(void *ptr)
+{
+#ifdef LOG_ASYNC
+	log_t *l = (log_t *)ptr;
+	while(  !l->async->stop.load()  ) {
+		pthread_mutex_lock( &l->async->write_mutex );
+		const uint32 written = l->write_queued();
+		pthread_mutex_unlock( &l->async->write_mutex );
+		if(  written == 0  ) {
+			dr_sleep( LOG_WRITER_SLEEP_MS );
+		}
+	}
+#else
+	(void)ptr;
+#endif
+	return NULL;
+}
+
+
+void log_t::set_async(bool on)
+{
+#ifdef LOG_ASYNC
+	if(  on  &&  async == NULL  &&  (log  ||  tee)  ) {
+		async = new async_t();
+		for(  uint32 i = 0;  i < LOG_QUEUE_SIZE;  i++  ) {
+			async->records[i].sequence.store( i );
+		}
+		async->head.store( 0 );
+		async->tail = 0;
+		async->stop.store( false );
+		pthread_mutex_init( &async->write_mutex, NULL );
+		if(  pthread_create( &async->writer, NULL, writer_thread, this ) != 0  ) {
+			pthread_mutex_destroy( &async->write_mutex );
+			delete async;
+			async = NULL;
+			warning( "log_t::set_async()", "Cannot start the log writer, writing directly" );
+		}
+	}
+	else if(  !on  &&  async != NULL  ) {
+		async->stop.store( true );
+		pthread_join( async->writer, NULL );
+		write_queued( true );
+
+		uint32 suppressed = 0;
+		for(  uint32 i = 0;  i <= LEVEL_DEBUG;  i++  ) {
+			suppressed += async->rates[i].suppressed.load();
+		}
+
+		pthread_mutex_destroy( &async->write_mutex );
+		delete async;
+		async = NULL;
+
+		if(  suppressed  ) {
+			message( "log_t::set_async()", "%u log records suppressed before (more than %d per second)", suppressed, LOG_RATE_LIMIT );
+		}
+		if(  log  ) {
+			fflush( log );
+		}
+	}
+#else
+	(void)on;
+#endif
+}
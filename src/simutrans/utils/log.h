@@ -58,6 +58,31 @@ private:
 	bool syslog;
 #endif
 
+	/**
+	 * Queue and writer thread while writing in the background, see set_async()
+	 */
+	struct async_t;
+	async_t *async;
+
+	/**
+	 * Queues the record for the writer thread or drops it by the rate limit.
+	 * @returns false if not writing in the background, i.e. the record must be written directly
+	 */
+	bool write_async(const char *what, const char *who, const char *format, va_list args, level_t level, const char *suffix=NULL);
+
+	/// debug messages and warnings are limited per level, see set_async()
+	bool is_rate_limited(level_t level, const char *who);
+	bool push_record(const char *text);
+	void write_text(const char *text);
+
+	/**
+	 * Writes the queued records, the write mutex must be locked.
+	 * @param all also wait for records which are still being filled
+	 */
+	uint32 write_queued(bool all=false);
+
+	static void *writer_thread(void *ptr);
+
 public:
 	/**
 	 * writes a debug message into the log.
@@ -102,6 +127,17 @@ public:
 
 	void close();
 
+	/**
+	 * With MULTI_THREAD the log file and console can be written by a background thread.
+	 * Any thread then only formats the record and puts it into a lock-free queue.
+	 * Debug messages and warnings are limited per second and level, the number of dropped
+	 * records is reported afterwards. Messages, errors and fatal errors are never dropped,
+	 * errors and fatal errors flush the queue.
+	 * Records written by the writer thread in the last few milliseconds before
+	 * a crash may be lost.
+	 */
+	void set_async(bool on);
+
 
 	/**
 	 * @param syslogtag only used with syslog
@@ -0,0 +1,249 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include <chrono>
+#include <stdio.h>
+
+#include "perf_timer.h"
+#include "cbuffer.h"
+#include "../simdebug.h"
+#include "../sys/simsys.h"
+#include "../tpl/vector_tpl.h"
+
+#ifdef MULTI_THREAD
+#include <pthread.h>
+#endif
+
+
+// more is not recorded, about 32 MB
+#define MAX_TRACE_EVENTS (1<<21)
+
+// the stats are shown summed over this time
+#define STATS_PERIOD_US (1000000)
+
+
+static const char *const perf_names[PERF_ID_COUNT] = {
+	"step",
+	"step convoys",
+	"step cities",
+	"step factories",
+	"step power",
+	"step players",
+	"step halts",
+	"sync step",
+	"sync buildings",
+	"sync smoke",
+	"sync pedestrians",
+	"sync roadsigns",
+	"sync moving objects",
+	"sync city cars",
+	"sync power",
+	"sync convoys",
+	"halt route search",
+	"vehicle route search",
+	"load game",
+	"save game",
+	"savegame stream",
+	"display world",
+	"display windows",
+	"display flush"
+};
+
+
+struct trace_event_t
+{
+	uint64 start;
+	uint32 duration;
+	uint8 id;
+};
+
+
+static perf_timer_t::stats_t current[PERF_ID_COUNT];
+static perf_timer_t::stats_t last[PERF_ID_COUNT];
+static uint32 current_frames = 0;
+static uint32 last_frames = 0;
+static uint64 period_start = 0;
+static uint64 paused_total = 0;
+
+static bool tracing = false;
+static uint64 trace_start = 0;
+static vector_tpl<trace_event_t> trace_events;
+
+#ifdef MULTI_THREAD
+static bool main_thread_known = false;
+static pthread_t main_thread;
+#endif
+
+
+static inline bool is_main_thread()
+{
+#ifdef MULTI_THREAD
+	return main_thread_known  &&  pthread_equal( pthread_self(), main_thread );
+#else
+	return true;
+#endif
+}
+
+
+uint64 perf_timer_t::get_time_us()
+{
+	return (uint64)std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+
+void perf_timer_t::set_main_thread()
+{
+#ifdef MULTI_THREAD
+	main_thread = pthread_self();
+	main_thread_known = true;
+#endif
+}
+
+
+void perf_timer_t::add(perf_id_t id, uint64 start_us, uint64 end_us, uint64 paused_us)
+{
+	if(  !is_main_thread()  ) {
+		return;
+	}
+	const uint32 duration = (uint32)(end_us - start_us - paused_us);
+	stats_t &s = current[id];
+	s.calls++;
+	s.time_us += duration;
+	if(  duration > s.max_us  ) {
+		s.max_us = duration;
+	}
+
+	if(  tracing  ) {
+		if(  trace_events.get_count() < MAX_TRACE_EVENTS  ) {
+			trace_event_t e;
+			e.start = start_us - trace_start;
+			// the whole call, the trace shows the paused time as the calls nested in it
+			e.duration = (uint32)(end_us - start_us);
+			e.id = (uint8)id;
+			trace_events.append( e );
+		}
+	}
+}
+
+
+uint64 perf_timer_t::get_paused_us()
+{
+	// only the main thread pauses, in interrupt_check()
+	return is_main_thread() ? paused_total : 0;
+}
+
+
+void perf_timer_t::add_paused(uint64 us)
+{
+	if(  is_main_thread()  ) {
+		paused_total += us;
+	}
+}
+
+
+void perf_timer_t::count(perf_id_t id, uint32 n)
+{
+	if(  is_main_thread()  ) {
+		current[id].count += n;
+	}
+}
+
+
+void perf_timer_t::new_frame()
+{
+	current_frames++;
+	const uint64 now = get_time_us();
+	if(  now - period_start >= STATS_PERIOD_US  ) {
+		for(  int i = 0;  i < PERF_ID_COUNT;  i++  ) {
+			last[i] = current[i];
+			current[i] = stats_t();
+		}
+		last_frames = current_frames;
+		current_frames = 0;
+		period_start = now;
+	}
+}
+
+
+const char *perf_timer_t::get_name(perf_id_t id)
+{
+	return perf_names[id];
+}
+
+
+const perf_timer_t::stats_t &perf_timer_t::get_stats(perf_id_t id)
+{
+	return last[id];
+}
+
+
+uint32 perf_timer_t::get_frames()
+{
+	return last_frames;
+}
+
+
+void perf_timer_t::print_stats(cbuffer_t &buf)
+{
+#ifdef NO_PERF_TIMERS
+	buf.append( "Compiled without timers.\n" );
+#else
+	if(  last_frames == 0  ) {
+		return;
+	}
+	buf.printf( "%u frames per second\n\n", last_frames );
+	for(  int i = 0;  i < PERF_ID_COUNT;  i++  ) {
+		const stats_t &s = last[i];
+		if(  s.calls == 0  ) {
+			continue;
+		}
+		buf.printf( "%s: %.2f ms/frame, %.1f calls/frame, max %.2f ms", perf_names[i], s.time_us / (1000.0 * last_frames), (double)s.calls / last_frames, s.max_us / 1000.0 );
+		if(  s.count  ) {
+			buf.printf( ", %.1f objects/frame", (double)s.count / last_frames );
+		}
+		buf.append( "\n" );
+	}
+#endif
+}
+
+
+void perf_timer_t::start_trace()
+{
+	trace_events.clear();
+	trace_start = get_time_us();
+	tracing = true;
+}
+
+
+bool perf_timer_t::stop_trace(const char *filename)
+{
+	tracing = false;
+
+	FILE *f = dr_fopen( filename, "w" );
+	if(  f == NULL  ) {
+		dbg->warning( "perf_timer_t::stop_trace()", "Cannot write trace to %s", filename );
+		return false;
+	}
+
+	fprintf( f, "{\"traceEvents\":[\n" );
+	for(  uint32 i = 0;  i < trace_events.get_count();  i++  ) {
+		const trace_event_t &e = trace_events[i];
+		fprintf( f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%u,\"pid\":1,\"tid\":1}\n",
+			i > 0 ? "," : "", perf_names[e.id], (unsigned long long)e.start, e.duration );
+	}
+	fprintf( f, "],\"displayTimeUnit\":\"ms\"}\n" );
+
+	if(  trace_events.get_count() >= MAX_TRACE_EVENTS  ) {
+		dbg->warning( "perf_timer_t::stop_trace()", "Trace was full, only the first %u calls were recorded", trace_events.get_count() );
+	}
+	trace_events.clear();
+	return fclose( f ) == 0;
+}
+
+
+bool perf_timer_t::is_tracing()
+{
+	return tracing;
+}
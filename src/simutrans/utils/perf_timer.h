@@ -0,0 +1,145 @@
+/*
+ * This file is part of the Simutrans project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef UTILS_PERF_TIMER_H
+#define UTILS_PERF_TIMER_H
+
+
+#include "../simtypes.h"
+
+class cbuffer_t;
+
+
+/// the measured parts of the game, see perf_timer_t
+enum perf_id_t {
+	PERF_STEP,
+	PERF_STEP_CONVOIS,
+	PERF_STEP_CITIES,
+	PERF_STEP_FACTORIES,
+	PERF_STEP_POWER,
+	PERF_STEP_PLAYERS,
+	PERF_STEP_HALTS,
+	PERF_SYNC_STEP,
+	PERF_SYNC_BUILDINGS,
+	PERF_SYNC_SMOKE,
+	PERF_SYNC_PEDESTRIANS,
+	PERF_SYNC_ROADSIGNS,
+	PERF_SYNC_MOVINGOBJS,
+	PERF_SYNC_CITYCARS,
+	PERF_SYNC_POWER,
+	PERF_SYNC_CONVOIS,
+	PERF_SEARCH_ROUTE,
+	PERF_CALC_ROUTE,
+	PERF_LOAD,
+	PERF_SAVE,
+	PERF_SAVEGAME_IO,
+	PERF_DISPLAY_WORLD,
+	PERF_DISPLAY_WINDOWS,
+	PERF_DISPLAY_FLUSH,
+	PERF_ID_COUNT
+};
+
+
+/**
+ * Timers and counters for the hot paths of the main loop.
+ * Place PERF_SCOPE(id) at the start of a block to time the rest of it.
+ * Time in a PERF_PAUSE() block, i.e. the sync step and display inside interrupt_check(),
+ * does not count for the scopes around it, only for the scopes inside.
+ * Only the main thread is measured, calls from worker threads are ignored.
+ * Compiling with NO_PERF_TIMERS removes all timers.
+ *
+ * The results are summed per frame (one sync step plus its display)
+ * and shown averaged over the last second in the timings window.
+ * While tracing, every timed call is also recorded and can be written
+ * in the trace event format of Chrome (about://tracing) or Perfetto.
+ */
+class perf_timer_t
+{
+public:
+	struct stats_t
+	{
+		uint32 calls;
+		uint32 count;
+		uint64 time_us;
+		uint32 max_us;
+	};
+
+	static uint64 get_time_us();
+
+	/// the thread whose calls are measured, called at startup
+	static void set_main_thread();
+
+	/// a call from @p start_us to @p end_us, of which @p paused_us were spent in PERF_PAUSE() blocks
+	static void add(perf_id_t id, uint64 start_us, uint64 end_us, uint64 paused_us);
+
+	/// the total time spent in PERF_PAUSE() blocks so far
+	static uint64 get_paused_us();
+	static void add_paused(uint64 us);
+
+	/// adds @p n to the counter of @p id, i.e. the number of objects processed
+	static void count(perf_id_t id, uint32 n);
+
+	/// starts the next frame, called by karte_t::sync_step()
+	static void new_frame();
+
+	static const char *get_name(perf_id_t id);
+
+	/// the stats of the last complete second, summed over its frames
+	static const stats_t &get_stats(perf_id_t id);
+	static uint32 get_frames();
+
+	/// appends a table of the stats of the last second
+	static void print_stats(cbuffer_t &buf);
+
+	/// starts recording every timed call
+	static void start_trace();
+
+	/**
+	 * Stops recording and writes the calls in the trace event format.
+	 * @returns false if the file cannot be written
+	 */
+	static bool stop_trace(const char *filename);
+
+	static bool is_tracing();
+};
+
+
+#ifndef NO_PERF_TIMERS
+
+/// times its own lifetime
+class perf_scope_t
+{
+	perf_id_t id;
+	uint64 start;
+	uint64 paused_start;
+
+public:
+	explicit perf_scope_t(perf_id_t id_) : id(id_), start(perf_timer_t::get_time_us()), paused_start(perf_timer_t::get_paused_us()) {}
+	~perf_scope_t() { perf_timer_t::add( id, start, perf_timer_t::get_time_us(), perf_timer_t::get_paused_us() - paused_start ); }
+};
+
+/// its lifetime does not count for the perf_scope_t around it
+class perf_pause_t
+{
+	uint64 start;
+
+public:
+	perf_pause_t() : start(perf_timer_t::get_time_us()) {}
+	~perf_pause_t() { perf_timer_t::add_paused( perf_timer_t::get_time_us() - start ); }
+};
+
+#define PERF_SCOPE(id) perf_scope_t perf_scope_##id(id)
+#define PERF_PAUSE() perf_pause_t perf_pause
+#define PERF_COUNT(id, n) perf_timer_t::count(id, n)
+
+#else
+
+#define PERF_SCOPE(id)
+#define PERF_PAUSE()
+#define PERF_COUNT(id, n)
+
+#endif
+
+#endif
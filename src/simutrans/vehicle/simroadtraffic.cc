@@ -235,6 +235,10 @@ void road_user_t::finish_rd()
 
 freelist_iter_tpl<private_car_t> private_car_t::fl;
 
+// With more city cars than this, each car is only moved every second sync step, with four times as many every fourth.
+// Keeps the sync step affordable on huge maps; cars still move as far per second and book the same way statistics.
+#define CITYCARS_COARSE_STEP (32768)
+
 static weighted_vector_tpl<const citycar_desc_t*> liste_timeline;
 stringhashtable_tpl<const citycar_desc_t *> private_car_t::table;
 
@@ -352,6 +356,20 @@ private_car_t::private_car_t(grund_t* gr, koord const target, const char* name)
 }
 
 
+void private_car_t::sync_handler(uint32 delta_t)
+{
+	const size_t count = fl.get_nodecout();
+	const uint32 parts = count > 4*CITYCARS_COARSE_STEP ? 4 : (count > CITYCARS_COARSE_STEP ? 2 : 1);
+	if(  parts == 1  ) {
+		fl.sync_step( delta_t );
+	}
+	else {
+		// the sync step counter is the same on all clients of a network game
+		fl.sync_step_part( delta_t*parts, welt->get_sync_steps() % parts, parts );
+	}
+}
+
+
 sync_result private_car_t::sync_step(uint32 delta_t)
 {
 	time_to_life -= delta_t;
@@ -118,7 +118,11 @@ public:
 	void* operator new(size_t) { return fl.gimme_node(); }
 	void operator delete(void* p) { return fl.putback_node(p); }
 
-	static void sync_handler(uint32 delta_t) { fl.sync_step(delta_t); }
+	/**
+	 * Moves all cars. With very many cars on the map, each car moves only every
+	 * second or fourth call but that much further, see CITYCARS_COARSE_STEP.
+	 */
+	static void sync_handler(uint32 delta_t);
 
 	void rotate90() OVERRIDE;
 
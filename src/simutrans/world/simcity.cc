@@ -493,28 +493,26 @@ class monument_placefinder_t : public placefinder_t {
 
 		bool is_tile_ok(koord pos, koord d, climate_bits cl) const OVERRIDE
 		{
-			const planquadrat_t* plan = welt->access(pos + d);
+			const koord k = pos + d;
 
 			// can't build here
-			if (plan == NULL) {
+			if (!welt->is_within_limits(k)) {
 				return false;
 			}
 
-			const grund_t* gr = plan->get_kartenboden();
-			if(  ((1 << welt->get_climate( gr->get_pos().get_2d() )) & cl) == 0  ) {
+			if(  ((1 << welt->get_tile_climate_nocheck(k)) & cl) == 0  ||  welt->get_ground_slope_nocheck(k) != slope_t::flat  ) {
 				return false;
 			}
 
+			const grund_t* gr = welt->lookup_kartenboden_nocheck(k);
 			if (is_boundary_tile(d)) {
 				return
-					gr->get_grund_hang() == slope_t::flat &&     // Flat
 					gr->get_typ() == grund_t::boden &&           // Boden -> no building
 					(!gr->hat_wege() || gr->hat_weg(road_wt)) && // only roads
 					gr->kann_alle_obj_entfernen(NULL) == NULL;   // Irgendwas verbaut den Platz?
 			}
 			else {
 				return
-					gr->get_grund_hang() == slope_t::flat &&
 					gr->get_typ() == grund_t::boden &&
 					gr->ist_natur() &&                         // No way here
 					gr->kann_alle_obj_entfernen(NULL) == NULL; // Irgendwas verbaut den Platz?
@@ -532,22 +530,24 @@ class townhall_placefinder_t : public placefinder_t {
 
 		bool is_tile_ok(koord pos, koord d, climate_bits cl) const OVERRIDE
 		{
-			const grund_t* gr = welt->lookup_kartenboden(pos + d);
-			if (gr == NULL  ||  gr->get_grund_hang() != slope_t::flat) {
+			const koord k = pos + d;
+			if (!welt->is_within_limits(k)  ||  welt->get_ground_slope_nocheck(k) != slope_t::flat) {
 				return false;
 			}
 
-			if(  ((1 << welt->get_climate( gr->get_pos().get_2d() )) & cl) == 0  ) {
+			if(  ((1 << welt->get_tile_climate_nocheck(k)) & cl) == 0  ) {
 				return false;
 			}
 
 			if (d.x > 0 || d.y > 0) {
-				if (welt->lookup_kartenboden(pos)->get_hoehe() != gr->get_hoehe()) {
+				if (welt->get_ground_hgt_nocheck(pos) != welt->get_ground_hgt_nocheck(k)) {
 					// height wrong!
 					return false;
 				}
 			}
 
+			const grund_t* gr = welt->lookup_kartenboden_nocheck(k);
+
 			if ( ((dir & ribi_t::south)!=0  &&  d.y == h - 1) ||
 				((dir & ribi_t::west)!=0  &&  d.x == 0) ||
 				((dir & ribi_t::north)!=0  &&  d.y == 0) ||
@@ -667,6 +667,8 @@ void stadt_t::recalc_city_size()
 {
 	// WARNING: do not call this during multithreaded loading,
 	// as has_low_density may depend on the order the buildings list is filled
+	const koord old_lo = lo;
+	const koord old_ur = ur;
 	lo = pos;
 	ur = pos;
 	for(gebaeude_t* const i : buildings) {
@@ -687,6 +689,10 @@ void stadt_t::recalc_city_size()
 
 	lo.clip_min(koord(0,0));
 	ur.clip_max(koord(welt->get_size().x-1,welt->get_size().y-1));
+
+	if(  lo != old_lo  ||  ur != old_ur  ) {
+		welt->update_city_limits( this, old_lo, old_ur );
+	}
 }
 
 
@@ -2643,8 +2649,11 @@ void stadt_t::check_bau_townhall(bool new_town)
 			bauer.build();
 		}
 		else if (neugruendung) {
+			const koord old_lo = lo;
+			const koord old_ur = ur;
 			lo = best_pos+offset - koord(2, 2);
 			ur = best_pos+offset + koord(desc->get_x(layout), desc->get_y(layout)) + koord(2, 2);
+			welt->update_city_limits( this, old_lo, old_ur );
 		}
 		const koord new_pos = best_pos + offset;
 		if(  pos!=new_pos  ) {
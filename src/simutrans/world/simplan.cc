@@ -96,6 +96,7 @@ void planquadrat_t::boden_hinzufuegen(grund_t *bd)
 		data.one = bd;
 		ground_size = 1;
 		minimap_t::get_instance()->calc_map_pixel(bd->get_pos().get_2d());
+		welt->update_tile_info(bd->get_pos().get_2d());
 		return;
 	}
 	else if(ground_size==1) {
@@ -112,6 +113,7 @@ DBG_MESSAGE("planquadrat_t::boden_hinzufuegen()","addition ground %s at (%i,%i,%
 		data.some = tmp;
 		ground_size = 2;
 		minimap_t::get_instance()->calc_map_pixel(bd->get_pos().get_2d());
+		welt->update_tile_info(bd->get_pos().get_2d());
 		return;
 	}
 	else {
@@ -144,6 +146,7 @@ DBG_MESSAGE("planquadrat_t::boden_hinzufuegen()","addition ground %s at (%i,%i,%
 		delete [] data.some;
 		data.some = tmp;
 		minimap_t::get_instance()->calc_map_pixel(bd->get_pos().get_2d());
+		welt->update_tile_info(bd->get_pos().get_2d());
 	}
 }
 
@@ -154,6 +157,7 @@ bool planquadrat_t::boden_entfernen(grund_t *bd)
 	if(ground_size==1) {
 		ground_size = 0;
 		data.one = NULL;
+		welt->update_tile_info(bd->get_pos().get_2d());
 		return true;
 	}
 	else {
@@ -171,6 +175,7 @@ bool planquadrat_t::boden_entfernen(grund_t *bd)
 					delete [] data.some;
 					data.one = tmp;
 				}
+				welt->update_tile_info(bd->get_pos().get_2d());
 				return true;
 			}
 		}
@@ -197,6 +202,7 @@ void planquadrat_t::kartenboden_setzen(grund_t *bd, bool startup)
 		bd->calc_image();
 	}
 	minimap_t::get_instance()->calc_map_pixel(bd->get_pos().get_2d());
+	welt->update_tile_info(bd->get_pos().get_2d());
 }
 
 
@@ -241,6 +247,7 @@ void planquadrat_t::boden_ersetzen(grund_t *alt, grund_t *neu)
 		}
 		delete alt;
 	}
+	welt->update_tile_info(neu->get_pos().get_2d());
 }
 
 
@@ -734,6 +741,10 @@ void planquadrat_t::halt_list_insert_at( halthandle_t halt, uint8 pos )
 void planquadrat_t::add_to_haltlist(halthandle_t halt, bool unsorted)
 {
 	if(halt.is_bound()) {
+		if(  get_kartenboden()->is_water()  ) {
+			// docks are found by their catchment on water
+			haltestelle_t::layout_changed();
+		}
 		if (!unsorted) {
 			// quick and dirty way to our 2d koodinates ...
 			const koord pos = get_kartenboden()->get_pos().get_2d();
@@ -806,9 +817,15 @@ void planquadrat_t::sort_haltlist()
  * removes the halt from a ground
  * however this function check, whether there is really no other part still reachable
  */
-void planquadrat_t::remove_from_haltlist(halthandle_t halt)
+void planquadrat_t::remove_from_haltlist(halthandle_t halt, bool check_coverage)
 {
 	halt_list_remove(halt);
+	if(  get_kartenboden()->is_water()  ) {
+		haltestelle_t::layout_changed();
+	}
+	if(  !check_coverage  ) {
+		return;
+	}
 
 	// We might still be connected (to a different tile on the halt, in which case reconnect.
 
@@ -210,8 +210,9 @@ public:
 	/**
 	* removes the halt from a ground
 	* however this function check, whether there is really no other part still reachable
+	* @param check_coverage false if the caller knows that no tile of the halt covers this one anymore
 	*/
-	void remove_from_haltlist(halthandle_t halt);
+	void remove_from_haltlist(halthandle_t halt, bool check_coverage = true);
 
 	/**
 	 * sort list of connected halts, ascending wrt distance to this tile
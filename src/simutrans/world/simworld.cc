@@ -92,10 +92,12 @@
 #include "../dataobj/environment.h"
 #include "../dataobj/powernet.h"
 #include "../dataobj/records.h"
+#include "../dataobj/step_arena.h"
 #include "../dataobj/pakset_manager.h"
 
 #include "../utils/cbuffer.h"
 #include "../utils/csv.h"
+#include "../utils/perf_timer.h"
 #include "../utils/simrandom.h"
 #include "../utils/simstring.h"
 
@@ -299,6 +301,11 @@ void karte_t::recalc_season_snowline(bool set_pending)
 	const sint8 summerline = max(settings.get_climate_borders(arctic_climate,1),settings.get_climate_borders(arctic_climate,0));
 	snowline = summerline - (sint8)(((summerline-winterline)*factor)/100);
 	if(  old_snowline != snowline  &&  set_pending  ) {
+		if(  pending_snowline_change == 0  ) {
+			snowline_change_min = snowline_change_max = (sint8)old_snowline;
+		}
+		snowline_change_min = min( snowline_change_min, min( (sint8)old_snowline, snowline ) );
+		snowline_change_max = max( snowline_change_max, max( (sint8)old_snowline, snowline ) );
 		pending_snowline_change++;
 	}
 }
@@ -411,6 +418,7 @@ void karte_t::destroy()
 {
 	is_sound = false; // karte_t::play_sound_area_clipped needs valid zeiger (pointer/drawer)
 	destroying = true;
+	new_month_phase = MONTH_PHASE_NONE;
 	DBG_MESSAGE("karte_t::destroy()", "destroying world");
 
 	uint32 max_display_progress = 256+cities.get_count()*10 + haltestelle_t::get_alle_haltestellen().get_count() + convoi_array.get_count() + (cached_size.x*cached_size.y)*2;
@@ -450,6 +458,8 @@ void karte_t::destroy()
 
 	// removes all moving stuff from the sync_step
 	sync.clear();
+	sleeping_convois.clear();
+	sleeping_convoi_nr = 0;
 	sync_buildings.clear();
 	sync_roadsigns.clear();
 	old_progress += cached_size.x*cached_size.y;
@@ -494,6 +504,7 @@ void karte_t::destroy()
 
 	ls.set_progress( old_progress );
 	// dinge aufraeumen
+	free_tile_info();
 	cached_grid_size.x = cached_grid_size.y = 1;
 	cached_size.x = cached_size.y = 0;
 	delete [] plan;
@@ -529,6 +540,8 @@ void karte_t::destroy()
 
 	// hier nur entfernen, aber nicht loeschen
 	attractions.clear();
+	fab_index.clear();
+	city_index.clear();
 	DBG_MESSAGE("karte_t::destroy()", "attraction list destroyed");
 
 	delete scenario;
@@ -567,6 +580,7 @@ stadt_t *karte_t::create_city(const koord pos, sint32 citizens)
 
 	settings.set_city_count(settings.get_city_count() + 1);
 	cities.append(new_city, new_city->get_einwohner());
+	city_index.add( new_city, new_city->get_linksoben(), new_city->get_rechtsunten() );
 
 	// add links between this city and other cities as well as attractions
 	for(stadt_t *city : cities) {
@@ -590,7 +604,12 @@ bool karte_t::remove_city(stadt_t *s)
 	if(s->get_name()) {
 		DBG_MESSAGE("karte_t::remove_city()", "%s", s->get_name());
 	}
+	if(  new_month_phase == MONTH_PHASE_CITIES  &&  cities.is_contained(s)  &&  cities.index_of(s) < new_month_next_city  ) {
+		// keep the pending month rollover at the same next city
+		new_month_next_city--;
+	}
 	cities.remove(s);
+	city_index.remove( s, s->get_linksoben(), s->get_rechtsunten() );
 	DBG_DEBUG4("karte_t::remove_city()", "reduce city to %i", settings.get_city_count() - 1);
 	settings.set_city_count(settings.get_city_count() - 1);
 
@@ -626,6 +645,7 @@ void karte_t::init_tiles()
 	MEMZERON(grid_hgts, (x + 1) * (y + 1));
 	water_hgts = new sint8[x * y];
 	MEMZERON(water_hgts, x * y);
+	init_tile_info();
 
 	win_set_world( this );
 	minimap_t::get_instance()->init();
@@ -654,6 +674,7 @@ void karte_t::init_tiles()
 	last_frame_idx = 0;
 	pending_season_change = 0;
 	pending_snowline_change = 0;
+	snowline_change_min = snowline_change_max = 0;
 
 	// init global history
 	for (int year=0; year<MAX_WORLD_HISTORY_YEARS; year++) {
@@ -669,6 +690,7 @@ void karte_t::init_tiles()
 	last_month_bev = 0;
 
 	tile_counter = 0;
+	new_month_phase = MONTH_PHASE_NONE;
 
 	convoihandle_t::init( 1024 );
 	linehandle_t::init( 1024 );
@@ -1733,11 +1755,20 @@ void karte_t::enlarge_map(settings_t const* sets, sint8 const* const h_field)
 {
 	const koord new_size(sets->get_size_x(), sets->get_size_y());
 
+	// the ways roll over their month in map order, which changes now
+	if(  new_month_phase == MONTH_PHASE_WAYS  ) {
+		sint32 all_ways = 0x7FFFFFFF;
+		step_new_month_ways( all_ways );
+	}
+
 	if(  cached_grid_size.y>0  &&  cached_grid_size.y!=new_size.y  ) {
 		// to keep the labels
 		grund_t::enlarge_map( new_size.x, new_size.y );
 	}
 
+	// the tile info must not be used until it has the new size
+	free_tile_info();
+
 	planquadrat_t *new_plan = new planquadrat_t[new_size.x*new_size.y];
 	sint8 *new_grid_hgts = new sint8[(new_size.x + 1) * (new_size.y + 1)];
 	sint8 *new_water_hgts = new sint8[new_size.x * new_size.y];
@@ -1755,6 +1786,8 @@ void karte_t::enlarge_map(settings_t const* sets, sint8 const* const h_field)
 	cached_size.x = cached_grid_size.x-1;
 	cached_size.y = cached_grid_size.y-1;
 
+	rebuild_spatial_index();
+
 	intr_disable();
 
 	const bool minimap_was_visible = minimap_t::is_visible;
@@ -1798,6 +1831,7 @@ void karte_t::enlarge_map(settings_t const* sets, sint8 const* const h_field)
 	grid_hgts = new_grid_hgts;
 	delete [] water_hgts;
 	water_hgts = new_water_hgts;
+	init_tile_info();
 
 	if(  new_world  ) {
 		// init max and min with defaults
@@ -1939,6 +1973,9 @@ void karte_t::enlarge_map(settings_t const* sets, sint8 const* const h_field)
 		ls.set_progress(15);
 	}
 
+	// the climates were set without updating the tile info
+	init_tile_info();
+
 	if (  new_world  ) {
 		// new world -> calculate all transitions
 		world_xy_loop(&karte_t::recalc_transitions_loop, 0);
@@ -2085,6 +2122,7 @@ karte_t::karte_t() :
 	network_frame_count = 0;
 	sync_steps = 0;
 	sync_steps_barrier = sync_steps;
+	sleeping_convoi_nr = 0;
 
 	for(  uint i=0;  i<MAX_PLAYER_COUNT;  i++  ) {
 		selected_tool[i] = tool_t::general_tool[TOOL_QUERY];
@@ -2117,6 +2155,10 @@ karte_t::karte_t() :
 	scenario = NULL;
 
 	map_counter = 0;
+	new_month_phase = MONTH_PHASE_NONE;
+	new_month_locality_update = false;
+	new_month_next_tile = 0;
+	new_month_next_city = 0;
 
 	msg = new message_t();
 	chat_msg = new chat_message_t();
@@ -2430,6 +2472,12 @@ DBG_MESSAGE( "karte_t::rotate90()", "called" );
 	// assume we can save this rotation
 	nosave_warning = nosave = false;
 
+	// the ways roll over their month in map order, which changes now
+	if(  new_month_phase == MONTH_PHASE_WAYS  ) {
+		sint32 all_ways = 0x7FFFFFFF;
+		step_new_month_ways( all_ways );
+	}
+
 	//announce current target rotation
 	settings.rotate90();
 
@@ -2441,6 +2489,9 @@ DBG_MESSAGE( "karte_t::rotate90()", "called" );
 		s->release_factory_links();
 	}
 
+	// will be filled again after rotation
+	free_tile_info();
+
 	//rotate plans in parallel posix thread ...
 	rotate90_new_plan = new planquadrat_t[cached_grid_size.y * cached_grid_size.x];
 	rotate90_new_water = new sint8[cached_grid_size.y * cached_grid_size.x];
@@ -2482,6 +2533,8 @@ DBG_MESSAGE( "karte_t::rotate90()", "called" );
 	cached_grid_size.x = cached_grid_size.y;
 	cached_grid_size.y = wx;
 
+	init_tile_info();
+
 	// now step all towns (to generate passengers)
 	for (stadt_t* const i : cities) {
 		i->rotate90(cached_size.x);
@@ -2527,6 +2580,7 @@ DBG_MESSAGE( "karte_t::rotate90()", "called" );
 
 	//  rotate map search array
 	factory_builder_t::new_world();
+	rebuild_spatial_index();
 
 	// update minimap
 	if (minimap_t::is_visible) {
@@ -2550,6 +2604,9 @@ bool karte_t::add_fab(fabrik_t* fab)
 	//DBG_MESSAGE("karte_t::add_fab()","fab = %p",fab);
 	assert(fab != NULL);
 	fab_list.insert(fab);
+	koord fab_min, fab_max;
+	fab->get_building_area( fab_min, fab_max );
+	fab_index.add( fab, fab_min, fab_max );
 	goods_in_game.clear(); // Force rebuild of goods list
 	if (factorylist_frame_t* f = (factorylist_frame_t*)win_get_magic(magic_factorylist)) {
 		f->fill_list();
@@ -2561,9 +2618,16 @@ bool karte_t::add_fab(fabrik_t* fab)
 // beware: must remove also links from stops and towns
 bool karte_t::rem_fab(fabrik_t *fab)
 {
+	if(  new_month_phase == MONTH_PHASE_FACTORIES  &&  new_month_next_fab != fab_list.end()  &&  *new_month_next_fab == fab  ) {
+		// keep the pending month rollover valid
+		++new_month_next_fab;
+	}
 	if(!fab_list.remove( fab )) {
 		return false;
 	}
+	koord fab_min, fab_max;
+	fab->get_building_area( fab_min, fab_max );
+	fab_index.remove( fab, fab_min, fab_max );
 
 	// Force rebuild of goods list
 	goods_in_game.clear();
@@ -2663,41 +2727,104 @@ void karte_t::remove_label(koord k)
 
 // -------- Verwaltung von Staedten -----------------------------
 
+void karte_t::rebuild_spatial_index()
+{
+	fab_index.init( get_size() );
+	for(fabrik_t* const fab : fab_list) {
+		koord fab_min, fab_max;
+		fab->get_building_area( fab_min, fab_max );
+		fab_index.add( fab, fab_min, fab_max );
+	}
+	city_index.init( get_size() );
+	for(stadt_t* const s : cities) {
+		city_index.add( s, s->get_linksoben(), s->get_rechtsunten() );
+	}
+}
+
+
+void karte_t::update_city_limits(stadt_t *s, koord old_lo, koord old_ur)
+{
+	city_index.update( s, old_lo, old_ur, s->get_linksoben(), s->get_rechtsunten() );
+}
+
+
 stadt_t *karte_t::find_nearest_city(const koord k) const
 {
+	if(  !is_within_limits(k)  ||  cities.empty()  ) {
+		return NULL;
+	}
+
 	uint32 min_dist = 99999999;
-	bool contains = false;
-	stadt_t *best = NULL; // within city limits
-
-	if(  is_within_limits(k)  ) {
-		for(stadt_t* const s :  cities  ) {
-			if(  k.x >= s->get_linksoben().x  &&  k.y >= s->get_linksoben().y  &&  k.x < s->get_rechtsunten().x  &&  k.y < s->get_rechtsunten().y  ) {
-				const uint32 dist = koord_distance( k, s->get_center() );
-				if(  !contains  ) {
-					// no city within limits => this is best
-					best = s;
-					min_dist = dist;
-				}
-				else if(  dist < min_dist  ) {
-					best = s;
-					min_dist = dist;
-				}
-				contains = true;
-			}
-			else if(  !contains  ) {
-				// so far no cities found within its city limit
-				const uint32 dist = koord_distance( k, s->get_center() );
-				if(  dist < min_dist  ) {
-					best = s;
-					min_dist = dist;
-				}
-			}
+	stadt_t *best = NULL;
+	// equal distance: take the first one in the city list, so the result does not depend on the index
+	const auto consider = [&]( stadt_t *s ) {
+		const uint32 dist = koord_distance( k, s->get_center() );
+		if(  best == NULL  ||  dist < min_dist  ||  (dist == min_dist  &&  cities.index_of(s) < cities.index_of(best))  ) {
+			best = s;
+			min_dist = dist;
+		}
+	};
+
+	// prefers cities within their limits
+	vector_tpl<stadt_t *> candidates;
+	city_index.find_area( k, k, candidates );
+	for(stadt_t* const s : candidates) {
+		if(  k.x >= s->get_linksoben().x  &&  k.y >= s->get_linksoben().y  &&  k.x < s->get_rechtsunten().x  &&  k.y < s->get_rechtsunten().y  ) {
+			consider( s );
+		}
+	}
+	if(  best  ) {
+		return best;
+	}
+
+	// Otherwise the closest center. A center is inside the city limits,
+	// so any city with a center within distance r overlaps the square of radius r.
+	for(  sint32 r = 32;  ;  r *= 2  ) {
+		candidates.clear();
+		city_index.find_area( k - koord( r, r ), k + koord( r, r ), candidates );
+		for(stadt_t* const s : candidates) {
+			consider( s );
 		}
+		if(  best  &&  min_dist <= (uint32)r  ) {
+			return best;
+		}
+		if(  r >= get_size_max()  ) {
+			break;
+		}
+	}
+
+	// not all cities indexed (yet)
+	for(stadt_t* const s : cities) {
+		consider( s );
 	}
 	return best;
 }
 
 
+void karte_t::sleep_convoi(convoihandle_t cnv, uint32 wake_tick)
+{
+	sleeping_convoi_t sc;
+	sc.wake_tick = wake_tick;
+	sc.nr = sleeping_convoi_nr++;
+	sc.cnv = cnv;
+	sleeping_convois.append( sc );
+	std::push_heap( sleeping_convois.begin(), sleeping_convois.end(), sleeping_convoi_t::later );
+}
+
+
+void karte_t::wake_sleeping_convois()
+{
+	while(  !sleeping_convois.empty()  &&  (sint32)(ticks - sleeping_convois[0].wake_tick) >= 0  ) {
+		std::pop_heap( sleeping_convois.begin(), sleeping_convois.end(), sleeping_convoi_t::later );
+		const sleeping_convoi_t sc = sleeping_convois.pop_back();
+		// the handle may be unbound or reused by now
+		if(  sc.cnv.is_bound()  &&  sc.cnv->end_sleep( sc.wake_tick )  ) {
+			sync.add( sc.cnv.get_rep() );
+		}
+	}
+}
+
+
 /*
  * this routine is called before an image is displayed
  * it moves vehicles and pedestrians
@@ -2706,6 +2833,8 @@ stadt_t *karte_t::find_nearest_city(const koord k) const
  */
 void karte_t::sync_step(uint32 delta_t)
 {
+	perf_timer_t::new_frame();
+	PERF_SCOPE(PERF_SYNC_STEP);
 	set_random_mode( SYNC_STEP_RANDOM );
 
 	// only omitted, when called to display a new frame during fast forward
@@ -2720,22 +2849,41 @@ void karte_t::sync_step(uint32 delta_t)
 	/* animations do not require exact sync
 	 * foundations etc are added removed frequently during city growth
 	 */
-	sync_buildings.sync_step(delta_t);
-
-	wolke_t::sync_handler(delta_t);
-
-	pedestrian_t::sync_handler(delta_t);
+	{
+		PERF_SCOPE(PERF_SYNC_BUILDINGS);
+		sync_buildings.sync_step(delta_t);
+	}
+	{
+		PERF_SCOPE(PERF_SYNC_SMOKE);
+		wolke_t::sync_handler(delta_t);
+	}
+	{
+		PERF_SCOPE(PERF_SYNC_PEDESTRIANS);
+		pedestrian_t::sync_handler(delta_t);
+	}
 
 	// the following sync_steps affect the game state
-	sync_roadsigns.sync_step(delta_t);
-
-	movingobj_t::sync_handler(delta_t);
-
-	private_car_t::sync_handler(delta_t);
-
-	senke_t::sync_handler(delta_t);
-
-	sync.sync_step( delta_t );
+	{
+		PERF_SCOPE(PERF_SYNC_ROADSIGNS);
+		sync_roadsigns.sync_step(delta_t);
+	}
+	{
+		PERF_SCOPE(PERF_SYNC_MOVINGOBJS);
+		movingobj_t::sync_handler(delta_t);
+	}
+	{
+		PERF_SCOPE(PERF_SYNC_CITYCARS);
+		private_car_t::sync_handler(delta_t);
+	}
+	{
+		PERF_SCOPE(PERF_SYNC_POWER);
+		senke_t::sync_handler(delta_t);
+	}
+	{
+		PERF_SCOPE(PERF_SYNC_CONVOIS);
+		wake_sleeping_convois();
+		sync.sync_step( delta_t );
+	}
 
 	ticker::update();
 
@@ -2940,9 +3088,17 @@ inline sint32 get_population(stadt_t const* const c)
 }
 
 
+// work units per step for the pending month rollover (a way costs one unit)
+#define NEW_MONTH_UNITS_PER_STEP (65536)
+#define TILE_NEW_MONTH_UNITS (1)
+#define FACTORY_NEW_MONTH_UNITS (64)
+#define CITY_NEW_MONTH_UNITS (256)
+
+
 void karte_t::new_month()
 {
-	bool need_locality_update = false;
+	// the previous month must be completely done before starting a new one
+	finish_new_month();
 
 	update_history();
 
@@ -2954,6 +3110,7 @@ void karte_t::new_month()
 		}
 	}
 
+	new_month_locality_update = false;
 	current_month++;
 	last_month++;
 	if( last_month > 11 ) {
@@ -2961,7 +3118,7 @@ void karte_t::new_month()
 		// check for changed distance weight
 		uint32 old_locality_factor = koord::locality_factor;
 		koord::locality_factor = settings.get_locality_factor( last_year + 1 );
-		need_locality_update = (old_locality_factor != koord::locality_factor);
+		new_month_locality_update = (old_locality_factor != koord::locality_factor);
 
 		if( current_month > DEFAULT_RETIRE_DATE * 12 ) {
 			// switch off timeline after 2999, since everything retires
@@ -2971,32 +3128,7 @@ void karte_t::new_month()
 	}
 	DBG_MESSAGE( "karte_t::new_month()", "Month (%d/%d) has started", (last_month % 12) + 1, last_month / 12 );
 
-	// this should be done before a map update, since the map may want an update of the way usage
-	for(weg_t* const w : weg_t::get_alle_wege() ) {
-		w->new_month();
-	}
-
-	// recalc old settings (and maybe update the stops with the current values)
-	minimap_t::get_instance()->new_month();
-
-	INT_CHECK( "simworld 1701" );
-
-//	DBG_MESSAGE("karte_t::new_month()","factories");
-	for(fabrik_t* const fab : fab_list) {
-		fab->new_month();
-	}
-	INT_CHECK("simworld 1278");
-
-
-//	DBG_MESSAGE("karte_t::new_month()","cities");
-	cities.update_weights(get_population);
-	for(stadt_t* const i : cities) {
-		i->new_month(need_locality_update);
-	}
-
-	INT_CHECK("simworld 1282");
-
-	// player
+	// player, convoys and halts book the income, so they must start the new month right now
 	for(uint i=0; i<MAX_PLAYER_COUNT; i++) {
 		if( i>=2  &&  last_month == 0  &&  !settings.is_freeplay() ) {
 			// remove all player (but first and second) who went bankrupt during last year
@@ -3034,31 +3166,157 @@ void karte_t::new_month()
 		INT_CHECK("simworld 1877");
 	}
 
-	INT_CHECK("simworld 2522");
-	depot_t::new_month();
+	// ways, factories and cities are done in the next steps by step_new_month()
+	new_month_next_tile = 0;
+	new_month_next_city = 0;
+	cities.update_weights(get_population);
+	new_month_phase = MONTH_PHASE_WAYS;
+
+	// start with the first slice right away
+	step_new_month( NEW_MONTH_UNITS_PER_STEP );
+}
 
-	scenario->new_month();
 
-	// now switch year to get the right year for all timeline stuff ...
-	if( last_month == 0 ) {
-		new_year();
-		INT_CHECK("simworld 1299");
+void karte_t::step_new_month_ways(sint32 &units)
+{
+	// in map order, which is the same after loading; removing ways thus needs no care
+	const uint32 tile_count = (uint32)cached_grid_size.x * (uint32)cached_grid_size.y;
+	while(  units > 0  &&  new_month_next_tile < tile_count  ) {
+		const planquadrat_t &pl = plan[new_month_next_tile++];
+		for(  uint8 i = 0;  i < pl.get_boden_count();  i++  ) {
+			const grund_t *gr = pl.get_boden_bei(i);
+			for(  int j = 0;  j < 2;  j++  ) {
+				if(  weg_t *w = gr->get_weg_nr(j)  ) {
+					w->new_month();
+					units--;
+				}
+			}
+		}
+		units -= TILE_NEW_MONTH_UNITS;
 	}
 
-	way_builder_t::new_month();
-	INT_CHECK("simworld 1299");
+	if(  new_month_next_tile >= tile_count  ) {
+		// this should be done before a map update, since the map may want an update of the way usage
+		// recalc old settings (and maybe update the stops with the current values)
+		minimap_t::get_instance()->new_month();
 
-	recalc_average_speed();
-	INT_CHECK("simworld 1921");
+		// the factory list is only walked from now on, removing factories keeps it valid, see rem_fab()
+		new_month_next_fab = fab_list.begin();
+		new_month_phase = MONTH_PHASE_FACTORIES;
+	}
+}
 
-	// update toolbars (i.e. new waytypes
-	tool_t::update_toolbars();
 
-	// no autosave in networkmode or when the new world dialogue is shown
-	if( !env_t::networkmode  &&  env_t::autosave>0  &&  last_month%env_t::autosave==0  &&  !win_get_magic(magic_welt_gui_t)  ) {
-		char buf[128];
-		sprintf( buf, "save/autosave%02i.sve", last_month+1 );
-		save( buf, true, env_t::savegame_version_str, true );
+void karte_t::step_new_month(sint32 units)
+{
+	while(  new_month_phase != MONTH_PHASE_NONE  &&  units > 0  ) {
+		switch(  new_month_phase  ) {
+			case MONTH_PHASE_WAYS:
+				step_new_month_ways( units );
+				break;
+
+			case MONTH_PHASE_FACTORIES:
+				while(  units > 0  &&  new_month_next_fab != fab_list.end()  ) {
+					(*new_month_next_fab)->new_month();
+					++new_month_next_fab;
+					units -= FACTORY_NEW_MONTH_UNITS;
+				}
+				if(  new_month_next_fab == fab_list.end()  ) {
+					new_month_phase = MONTH_PHASE_CITIES;
+				}
+				break;
+
+			case MONTH_PHASE_CITIES:
+				while(  units > 0  &&  new_month_next_city < cities.get_count()  ) {
+					cities[new_month_next_city++]->new_month( new_month_locality_update );
+					units -= CITY_NEW_MONTH_UNITS;
+				}
+				if(  new_month_next_city >= cities.get_count()  ) {
+					new_month_phase = MONTH_PHASE_FINISH;
+				}
+				break;
+
+			case MONTH_PHASE_FINISH:
+				// everything has its month-end values now
+				new_month_phase = MONTH_PHASE_NONE;
+
+				depot_t::new_month();
+
+				scenario->new_month();
+
+				// now switch year to get the right year for all timeline stuff ...
+				if( last_month == 0 ) {
+					new_year();
+					INT_CHECK("simworld 1299");
+				}
+
+				way_builder_t::new_month();
+				INT_CHECK("simworld 1299");
+
+				recalc_average_speed();
+				INT_CHECK("simworld 1921");
+
+				// update toolbars (i.e. new waytypes
+				tool_t::update_toolbars();
+
+				// no autosave in networkmode or when the new world dialogue is shown
+				if( !env_t::networkmode  &&  env_t::autosave>0  &&  last_month%env_t::autosave==0  &&  !win_get_magic(magic_welt_gui_t)  ) {
+					char buf[128];
+					sprintf( buf, "save/autosave%02i.sve", last_month+1 );
+					save( buf, true, env_t::savegame_version_str, true );
+				}
+				break;
+
+			default:
+				dbg->fatal( "karte_t::step_new_month()", "Unknown month phase %i", new_month_phase );
+		}
+		INT_CHECK("simworld 1877");
+	}
+}
+
+
+void karte_t::rdwr_new_month(loadsave_t *file)
+{
+	xml_tag_t t( file, "new_month_t" );
+
+	file->rdwr_byte( new_month_phase );
+	file->rdwr_bool( new_month_locality_update );
+
+	// the cursor of the current phase
+	uint32 next = 0;
+	if(  file->is_saving()  ) {
+		switch(  new_month_phase  ) {
+			case MONTH_PHASE_WAYS:
+				next = new_month_next_tile;
+				break;
+			case MONTH_PHASE_FACTORIES:
+				for(  slist_tpl<fabrik_t *>::iterator i = fab_list.begin();  i != new_month_next_fab;  ++i  ) {
+					next++;
+				}
+				break;
+			case MONTH_PHASE_CITIES:
+				next = new_month_next_city;
+				break;
+		}
+	}
+	file->rdwr_long( next );
+
+	if(  file->is_loading()  ) {
+		if(  new_month_phase > MONTH_PHASE_FINISH  ) {
+			dbg->fatal( "karte_t::rdwr_new_month()", "Savegame file mangled (unknown month phase %i)!", new_month_phase );
+		}
+		// the factories and cities are loaded in the order they were saved
+		new_month_next_tile = next;
+		new_month_next_fab = fab_list.begin();
+		if(  new_month_phase == MONTH_PHASE_FACTORIES  ) {
+			for(  ;  next > 0  &&  new_month_next_fab != fab_list.end();  next--  ) {
+				++new_month_next_fab;
+			}
+		}
+		new_month_next_city = next;
+		if(  new_month_phase != MONTH_PHASE_NONE  ) {
+			DBG_MESSAGE( "karte_t::rdwr_new_month()", "resume month rollover in phase %i", new_month_phase );
+		}
 	}
 }
 
@@ -3212,8 +3470,152 @@ void karte_t::set_schedule_counter()
 }
 
 
+#ifdef MULTI_THREAD
+// below this many factories a thread costs more than it saves
+#define MIN_FACTORIES_PER_THREAD (256)
+
+struct factory_thread_param_t
+{
+	fabrik_t *const *fabs;
+	uint32 count;
+	uint32 delta_t;
+};
+
+
+void *karte_t::step_factories_thread(void *ptr)
+{
+	const factory_thread_param_t *param = reinterpret_cast<factory_thread_param_t *>(ptr);
+	for(  uint32 i=0;  i<param->count;  i++  ) {
+		param->fabs[i]->step_production( param->delta_t );
+	}
+	return NULL;
+}
+#endif
+
+
+void karte_t::step_factories(uint32 delta_t)
+{
+	// stays valid across the INT_CHECKs of step_distribution(), only end_step() rewinds the arena
+	step_vector_tpl<fabrik_t *> fabs( fab_list.get_count() );
+	for(fabrik_t* const f : fab_list) {
+		fabs.append( f );
+	}
+
+#ifdef MULTI_THREAD
+	const uint32 threads = min( (uint32)env_t::num_threads, fabs.get_count() / MIN_FACTORIES_PER_THREAD );
+	if(  threads > 1  ) {
+		// no sync_step or display from the worker threads
+		const bool intr_was_enabled = intr_is_enabled();
+		intr_disable();
+		set_random_mode( INTERACTIVE_RANDOM ); // do not allow simrand() here!
+
+		// each factory only changes itself, so the result is the same as in a serial run
+		pthread_t thread[MAX_THREADS];
+		bool started[MAX_THREADS];
+		factory_thread_param_t param[MAX_THREADS];
+		for(  uint32 t=0;  t<threads;  t++  ) {
+			const uint32 start = (t * fabs.get_count()) / threads;
+			param[t].fabs = fabs.begin() + start;
+			param[t].count = ((t + 1) * fabs.get_count()) / threads - start;
+			param[t].delta_t = delta_t;
+		}
+		for(  uint32 t=1;  t<threads;  t++  ) {
+			started[t] = pthread_create( &thread[t], NULL, step_factories_thread, (void *)&param[t] ) == 0;
+		}
+		step_factories_thread( &param[0] );
+		for(  uint32 t=1;  t<threads;  t++  ) {
+			if(  started[t]  ) {
+				pthread_join( thread[t], NULL );
+			}
+			else {
+				step_factories_thread( &param[t] );
+			}
+		}
+
+		clear_random_mode( INTERACTIVE_RANDOM );
+		if(  intr_was_enabled  ) {
+			intr_enable();
+		}
+	}
+	else
+#endif
+	{
+		for(fabrik_t* const f : fabs) {
+			f->step_production( delta_t );
+		}
+	}
+
+	// the goods go to the halts and random numbers are drawn always in the same order
+	for(fabrik_t* const f : fabs) {
+		f->step_distribution( delta_t );
+	}
+}
+
+
+#ifdef MULTI_THREAD
+void *karte_t::plan_player_thread(void *ptr)
+{
+	reinterpret_cast<player_t *>(ptr)->plan();
+	return NULL;
+}
+#endif
+
+
+void karte_t::plan_players()
+{
+	player_t *planners[MAX_PLAYER_COUNT];
+	uint32 count = 0;
+	for(  int i=0;  i<MAX_PLAYER_COUNT;  i++  ) {
+		if(  players[i] != NULL  &&  players[i]->wants_to_plan()  ) {
+			planners[count++] = players[i];
+		}
+	}
+	if(  count == 0  ) {
+		return;
+	}
+
+	set_random_mode( INTERACTIVE_RANDOM ); // do not allow simrand() here!
+#ifdef MULTI_THREAD
+	// scripted scenarios check the construction sites in their script, which must stay on the main thread
+	if(  count > 1  &&  env_t::num_threads > 1  &&  !scenario->is_scripted()  ) {
+		// no sync_step or display from the worker threads
+		const bool intr_was_enabled = intr_is_enabled();
+		intr_disable();
+
+		// the world does not change until all threads are joined, so the plans are the same as in a serial run
+		pthread_t thread[MAX_PLAYER_COUNT];
+		bool started[MAX_PLAYER_COUNT];
+		for(  uint32 i=1;  i<count;  i++  ) {
+			started[i] = pthread_create( &thread[i], NULL, plan_player_thread, (void *)planners[i] ) == 0;
+		}
+		planners[0]->plan();
+		for(  uint32 i=1;  i<count;  i++  ) {
+			if(  started[i]  ) {
+				pthread_join( thread[i], NULL );
+			}
+			else {
+				planners[i]->plan();
+			}
+		}
+
+		if(  intr_was_enabled  ) {
+			intr_enable();
+		}
+	}
+	else
+#endif
+	{
+		for(  uint32 i=0;  i<count;  i++  ) {
+			planners[i]->plan();
+		}
+	}
+	clear_random_mode( INTERACTIVE_RANDOM );
+}
+
+
 void karte_t::step()
 {
+	PERF_SCOPE(PERF_STEP);
 	DBG_DEBUG4("karte_t::step", "start step");
 	uint32 time = dr_time();
 
@@ -3234,6 +3636,10 @@ void karte_t::step()
 		DBG_DEBUG4("karte_t::step", "calling new_month");
 		new_month();
 	}
+	else if(  new_month_phase != MONTH_PHASE_NONE  ) {
+		DBG_DEBUG4("karte_t::step", "calling step_new_month");
+		step_new_month( NEW_MONTH_UNITS_PER_STEP );
+	}
 
 	DBG_DEBUG4("karte_t::step", "time calculations");
 	if(  step_mode==NORMAL  ) {
@@ -3296,13 +3702,23 @@ void karte_t::step()
 	if(  season_change  ||  snowline_change  ) {
 		DBG_DEBUG4("karte_t::step", "pending_season_change");
 		// process
-		const uint32 end_count = min( cached_grid_size.x * cached_grid_size.y,  tile_counter + max( 16384, cached_grid_size.x * cached_grid_size.y / 16 ) );
-		while(  tile_counter < end_count  ) {
-			plan[tile_counter].check_season_snowline( season_change, snowline_change );
-			tile_counter++;
-			if(  (tile_counter & 0x3FF) == 0  ) {
-				INT_CHECK("karte_t::step");
+		const uint32 tile_count = (uint32)cached_grid_size.x * (uint32)cached_grid_size.y;
+		const uint32 max_updates = max( 16384u, tile_count / 16 );
+		// if only the snowline changed, the images of tiles far above or below it stay the same
+		// (some objects already use snow one height below the snowline, buildings may be two heights above their ground)
+		const sint16 band_min = snowline_change_min - 2;
+		const sint16 band_max = snowline_change_max + 1;
+		uint32 updates = 0;
+		while(  tile_counter < tile_count  &&  updates < max_updates  ) {
+			const sint16 hgt = ground_hgts[tile_counter];
+			if(  season_change  ||  (tile_flags[tile_counter] & TILE_MORE_GROUNDS)  ||  (hgt <= band_max  &&  hgt + slope_t::max_diff( ground_slopes[tile_counter] ) + 2 >= band_min)  ) {
+				plan[tile_counter].check_season_snowline( season_change, snowline_change );
+				updates++;
+				if(  (updates & 0x3FF) == 0  ) {
+					INT_CHECK("karte_t::step");
+				}
 			}
+			tile_counter++;
 		}
 
 		if(  tile_counter >= (uint32)cached_grid_size.x * (uint32)cached_grid_size.y  ) {
@@ -3319,49 +3735,71 @@ void karte_t::step()
 	// to make sure the tick counter will be updated
 	INT_CHECK("karte_t::step");
 
+	// catchments changed by building or removing stops
+	haltestelle_t::relink_pending_factories();
+
 	DBG_DEBUG4("karte_t::step", "step convois");
-	// since convois will be deleted during stepping, we need to step backwards
-	for (size_t i = convoi_array.get_count(); i-- != 0;) {
-		convoihandle_t cnv = convoi_array[i];
-		cnv->step();
-		if((i&15)==0) {
-			INT_CHECK("simworld 1947");
+	{
+		PERF_SCOPE(PERF_STEP_CONVOIS);
+		PERF_COUNT(PERF_STEP_CONVOIS, convoi_array.get_count());
+		// since convois will be deleted during stepping, we need to step backwards
+		for (size_t i = convoi_array.get_count(); i-- != 0;) {
+			convoihandle_t cnv = convoi_array[i];
+			cnv->step();
+			if((i&15)==0) {
+				INT_CHECK("simworld 1947");
+			}
 		}
 	}
 
 	// now step all towns (to generate passengers)
 	DBG_DEBUG4("karte_t::step", "step cities");
 	sint64 bev=0;
-	for(stadt_t* const i : cities) {
-		i->step(delta_t);
-		bev += i->get_finance_history_month(0, HIST_CITIZENS);
+	{
+		PERF_SCOPE(PERF_STEP_CITIES);
+		for(stadt_t* const i : cities) {
+			i->step(delta_t);
+			bev += i->get_finance_history_month(0, HIST_CITIZENS);
+		}
 	}
 
 	// the inhabitants stuff
 	finance_history_month[0][WORLD_CITIZENS] = bev;
 
 	DBG_DEBUG4("karte_t::step", "step factories");
-	for(fabrik_t* const f : fab_list) {
-		f->step(delta_t);
+	{
+		PERF_SCOPE(PERF_STEP_FACTORIES);
+		PERF_COUNT(PERF_STEP_FACTORIES, fab_list.get_count());
+		step_factories(delta_t);
 	}
 	finance_history_year[0][WORLD_FACTORIES] = finance_history_month[0][WORLD_FACTORIES] = fab_list.get_count();
 
 	// step powerlines - required order: powernet, pumpe then senke
 	DBG_DEBUG4("karte_t::step", "step poweline stuff");
-	powernet_t::step_all(delta_t);
-	pumpe_t::sync_handler(delta_t);
+	{
+		PERF_SCOPE(PERF_STEP_POWER);
+		powernet_t::step_all(delta_t);
+		pumpe_t::sync_handler(delta_t);
+	}
 //	senke_t::step_all(delta_t); // not needed, handeld by sunc_step already
 
 	DBG_DEBUG4("karte_t::step", "step players");
-	// then step all players
-	for(  int i=0;  i<MAX_PLAYER_COUNT;  i++  ) {
-		if(  players[i] != NULL  ) {
-			players[i]->step();
+	{
+		PERF_SCOPE(PERF_STEP_PLAYERS);
+		// first the read-only planning of the AIs, then step all players
+		plan_players();
+		for(  int i=0;  i<MAX_PLAYER_COUNT;  i++  ) {
+			if(  players[i] != NULL  ) {
+				players[i]->step();
+			}
 		}
 	}
 
 	DBG_DEBUG4("karte_t::step", "step halts");
-	haltestelle_t::step_all();
+	{
+		PERF_SCOPE(PERF_STEP_HALTS);
+		haltestelle_t::step_all();
+	}
 
 	// ok, next step
 	INT_CHECK("simworld 1975");
@@ -3406,6 +3844,9 @@ void karte_t::step()
 		}
 	}
 
+	// all scratch data of this step is gone now
+	step_arena_t::get_instance().end_step();
+
 	DBG_DEBUG4("karte_t::step", "end");
 }
 
@@ -3621,6 +4062,7 @@ bool karte_t::play_sound_area_clipped(koord const k, uint16 const idx, sound_typ
 
 void karte_t::save(const char *filename, bool autosave, const char *version_str, bool silent )
 {
+	PERF_SCOPE(PERF_SAVE);
 	dbg->message("karte_t::save", "%s game to '%s', version=%s, ticks=%u", autosave ? "Auto-saving" : "Saving", filename, version_str, ticks);
 
 	loadsave_t  file;
@@ -3663,6 +4105,7 @@ void karte_t::save(loadsave_t *file,bool silent)
 
 	loadingscreen_t *ls = NULL;
 DBG_MESSAGE("karte_t::save(loadsave_t *file)", "start");
+
 	if(!silent) {
 		ls = new loadingscreen_t( translator::translate("Saving map ..."), get_size().y );
 	}
@@ -3788,6 +4231,10 @@ DBG_MESSAGE("karte_t::save(loadsave_t *file)", "motd filename %s", env_t::server
 		records->rdwr(file);
 	}
 
+	if(  file->is_version_atleast(124, 3)  ) {
+		rdwr_new_month(file);
+	}
+
 	file->rdwr_byte( active_player_nr );
 
 	// save all open windows (upon request)
@@ -3876,6 +4323,7 @@ void karte_t::switch_server( bool start_server, bool port_forwarding )
 // just the preliminaries, opens the file, checks the versions ...
 bool karte_t::load(const char *filename)
 {
+	PERF_SCOPE(PERF_LOAD);
 	cbuffer_t name;
 	bool ok = false;
 	bool restore_player_nr = false;
@@ -4128,6 +4576,7 @@ void karte_t::load(loadsave_t *file)
 	loadingscreen_t ls(translator::translate("Loading map ..."), 1, true, true );
 
 	tile_counter = 0;
+	new_month_phase = MONTH_PHASE_NONE;
 	simloops = 60;
 
 	// jetzt geht das Laden los
@@ -4174,6 +4623,9 @@ DBG_MESSAGE("karte_t::load()", "%d ways loaded",weg_t::get_alle_wege().get_count
 
 	world_xy_loop(&karte_t::plans_finish_rd, SYNCX_FLAG);
 
+	// climates and grounds were read without updating the tile info
+	init_tile_info();
+
 	// update power nets with correct power
 	powernet_t::step_all(1);
 
@@ -4195,6 +4647,7 @@ DBG_MESSAGE("karte_t::load()", "laden_abschliesen for tiles finished" );
 		INT_CHECK("simworld 1278");
 	}
 	swap(cities, new_cities);
+	rebuild_spatial_index();
 	DBG_MESSAGE("karte_t::load()", "cities initialized");
 
 	ls.set_progress( (get_size().y*3)/2+256+get_size().y/4 );
@@ -4349,6 +4802,10 @@ DBG_MESSAGE("karte_t::load()", "%d factories loaded", fab_list.get_count());
 		records->rdwr(file);
 	}
 
+	if(  file->is_version_atleast(124, 3)  ) {
+		rdwr_new_month(file);
+	}
+
 	if(  file->is_version_atleast(102, 4)  ) {
 		if(  env_t::restore_UI  ) {
 			file->rdwr_byte( active_player_nr );
@@ -4371,6 +4828,45 @@ DBG_MESSAGE("karte_t::load()", "%d factories loaded", fab_list.get_count());
 }
 
 
+void karte_t::rdwr_tile_regions(loadsave_t *file, loadingscreen_t *ls)
+{
+	uint16 region_size = 256;
+	file->rdwr_short( region_size );
+	if(  region_size == 0  ) {
+		dbg->fatal( "karte_t::rdwr_tile_regions()", "Savegame file mangled (invalid region size)!" );
+	}
+	DBG_MESSAGE( "karte_t::rdwr_tile_regions()", "%s tiles in regions of %i", file->is_loading() ? "loading" : "saving", region_size );
+
+	for(  int ry = 0;  ry < get_size().y;  ry += region_size  ) {
+		const int y_end = min( ry + region_size, (int)get_size().y );
+
+		for(  int rx = 0;  rx < get_size().x;  rx += region_size  ) {
+			const int x_end = min( rx + region_size, (int)get_size().x );
+
+			block_loadsave_t block( file );
+			for(  int y = ry;  y < y_end;  y++  ) {
+				for(  int x = rx;  x < x_end;  x++  ) {
+					plan[x+y*cached_grid_size.x].rdwr( &block, koord(x,y) );
+				}
+			}
+			if(  block.is_loading()  &&  !block.is_consumed()  ) {
+				dbg->fatal( "karte_t::rdwr_tile_regions()", "Savegame file mangled (region %i,%i not fully read)!", rx, ry );
+			}
+		}
+
+		if(  file->is_loading()  ) {
+			ls->set_progress( y_end/2 );
+		}
+		else if(  !ls  ) {
+			INT_CHECK("saving");
+		}
+		else {
+			ls->set_progress( y_end );
+		}
+	}
+}
+
+
 void karte_t::rdwr_gamestate(loadsave_t *file, loadingscreen_t *ls)
 {
 	if (file->is_loading()) {
@@ -4569,6 +5065,8 @@ void karte_t::rdwr_gamestate(loadsave_t *file, loadingscreen_t *ls)
 			stadt_t *s = new stadt_t(file);
 			cities.append( s, s->get_einwohner());
 		}
+		// the buildings will look up their city while the tiles are finished
+		rebuild_spatial_index();
 	}
 	else {
 		for(stadt_t* const i : cities) {
@@ -4588,7 +5086,16 @@ void karte_t::rdwr_gamestate(loadsave_t *file, loadingscreen_t *ls)
 	}
 
 	// rdwr tiles
-	if (file->is_loading()) {
+	bool region_blocks = false;
+	if(  file->is_version_atleast(124, 3)  ) {
+		region_blocks = !file->is_xml();
+		file->rdwr_bool( region_blocks );
+	}
+
+	if(  region_blocks  ) {
+		rdwr_tile_regions( file, ls );
+	}
+	else if (file->is_loading()) {
 		DBG_MESSAGE("karte_t::rdwr_gamestate()","loading tiles");
 
 		for (int y = 0; y < get_size().y; y++) {
@@ -5554,6 +6061,7 @@ void karte_t::step_month( sint16 months )
 	while(  months-->0  ) {
 		new_month();
 	}
+	finish_new_month();
 	reset_timer();
 }
 
@@ -18,6 +18,7 @@
 #include "../tpl/array2d_tpl.h"
 #include "../tpl/vector_tpl.h"
 #include "../tpl/slist_tpl.h"
+#include "../tpl/spatial_index_tpl.h"
 
 #include "../dataobj/settings.h"
 #include "../dataobj/loadsave.h"
@@ -201,6 +202,12 @@ private:
 	sint8 pending_season_change;
 	sint8 pending_snowline_change;
 
+	/**
+	 * Lowest and highest snowline since the last complete snowline update.
+	 * If only the snowline changed, just the tiles near these heights get new images.
+	 */
+	sint8 snowline_change_min, snowline_change_max;
+
 	/**
 	 * Recalculates sleep time etc.
 	 */
@@ -211,6 +218,28 @@ private:
 	 */
 	vector_tpl<convoihandle_t> convoi_array;
 
+	/// a convoi waiting outside of the sync list, see sleep_convoi()
+	struct sleeping_convoi_t
+	{
+		uint32 wake_tick;
+		uint32 nr; ///< order of sleep_convoi() calls, for a deterministic order of waking
+		convoihandle_t cnv;
+
+		/// for the heap: the earliest one is on top
+		static bool later(const sleeping_convoi_t &a, const sleeping_convoi_t &b)
+		{
+			const sint32 diff = (sint32)(a.wake_tick - b.wake_tick);
+			return diff > 0  ||  (diff == 0  &&  (sint32)(a.nr - b.nr) > 0);
+		}
+	};
+
+	/// heap of the sleeping convois, may contain stale entries of convois woken up earlier
+	vector_tpl<sleeping_convoi_t> sleeping_convois;
+	uint32 sleeping_convoi_nr;
+
+	/// puts the convois back into the sync list, whose waiting is over
+	void wake_sleeping_convois();
+
 	/**
 	 * Array containing the factories.
 	 */
@@ -230,6 +259,16 @@ private:
 	 */
 	weighted_vector_tpl<stadt_t*> cities;
 
+	/**
+	 * Factory buildings and city limits by area,
+	 * so area and nearest searches need not visit every factory, city or tile.
+	 */
+	spatial_index_tpl<fabrik_t *> fab_index;
+	spatial_index_tpl<stadt_t *> city_index;
+
+	/// refills the spatial indices from scratch, after loading, resizing or rotating the map
+	void rebuild_spatial_index();
+
 	sint64 last_month_bev;
 
 	/**
@@ -452,6 +491,40 @@ private:
 	 */
 	uint32 tile_counter;
 
+	/**
+	 * The month rollover of ways, factories and cities is spread over the steps
+	 * following the month change, with a fixed amount of work per step, so it stays
+	 * deterministic. Until an object is reached, it still books to its old month.
+	 * The world history, players, convoys and halts, which book the income,
+	 * roll over at once, before the ways, factories and cities.
+	 * A pending rollover is saved with its phase and cursor and resumed after loading.
+	 */
+	enum new_month_phase_t {
+		MONTH_PHASE_NONE = 0,
+		MONTH_PHASE_WAYS,
+		MONTH_PHASE_FACTORIES,
+		MONTH_PHASE_CITIES,
+		MONTH_PHASE_FINISH
+	};
+	uint8 new_month_phase;
+	bool new_month_locality_update;
+
+	/// next tile (the ways are rolled over in map order), factory and city to process in the pending month rollover
+	uint32 new_month_next_tile;
+	slist_tpl<fabrik_t *>::iterator new_month_next_fab;
+	uint32 new_month_next_city;
+
+	/**
+	 * Processes pending month rollover phases until units are used up.
+	 */
+	void step_new_month(sint32 units);
+
+	/**
+	 * Rolls over the ways of the next tiles, until units are used up,
+	 * and starts the factory phase after the last tile.
+	 */
+	void step_new_month_ways(sint32 &units);
+
 	/**
 	 * To identify different stages of the same game.
 	 */
@@ -484,6 +557,18 @@ public:
 private:
 	void rdwr_gamestate(loadsave_t *file, loadingscreen_t *ls);
 
+	/**
+	 * Reads/writes the tiles as independent blocks of square map regions (since 124.3).
+	 * Each block is length prefixed, so it can be read in one go and checked for completeness.
+	 */
+	void rdwr_tile_regions(loadsave_t *file, loadingscreen_t *ls);
+
+	/**
+	 * Reads/writes the phase and cursor of a pending month rollover (since 124.3).
+	 * Must be called when all objects are loaded.
+	 */
+	void rdwr_new_month(loadsave_t *file);
+
 	/**
 	 * Removes all objects, deletes all data structures and frees all accessible memory.
 	 */
@@ -796,6 +881,17 @@ public:
 	 */
 	void step_month( sint16 months=1 );
 
+	/**
+	 * Completes the month rollover of all objects at once,
+	 * needed before changing the month again.
+	 */
+	void finish_new_month() { step_new_month( 0x7FFFFFFF ); }
+
+	/**
+	 * @returns true while the month rollover is still spread over the next steps
+	 */
+	bool is_new_month_pending() const { return new_month_phase != MONTH_PHASE_NONE; }
+
 	/**
 	 * @return Either 0 or the current year*12 + month
 	 */
@@ -1005,6 +1101,12 @@ public:
 	fabrik_t* get_fab(unsigned index) const { return index < fab_list.get_count() ? fab_list.at(index) : NULL; }
 	const slist_tpl<fabrik_t*>& get_fab_list() const { return fab_list; }
 
+	/// Appends all factories whose buildings overlap the rectangle @p min .. @p max (inclusive), in no particular order.
+	void find_factories(koord min, koord max, vector_tpl<fabrik_t *> &result) const { fab_index.find_area( min, max, result ); }
+
+	/// Must be called by a city whenever its limits change.
+	void update_city_limits(stadt_t *s, koord old_lo, koord old_ur);
+
 	/**
 	 * Returns a list of goods produced by factories that exist in current game.
 	 */
@@ -1047,6 +1149,8 @@ public:
 			list.append(obj);
 		}
 
+		bool is_stepping() const { return sync_step_running; }
+
 		void remove(T *obj)
 		{
 			if(sync_step_running) {
@@ -1081,6 +1185,8 @@ public:
 						ss = list.pop_back();
 						if (i < list.get_count()) {
 							list[i] = ss;
+							// the moved one must be stepped too
+							i--;
 						}
 				}
 			}
@@ -1097,6 +1203,13 @@ public:
 	};
 
 	sync_list_t<convoi_t>   sync;           ///< vehicles
+
+	/**
+	 * A convoi waiting for a long time removes itself from the sync list.
+	 * It is added again during the first sync step at or after @p wake_tick,
+	 * if convoi_t::end_sleep() agrees.
+	 */
+	void sleep_convoi(convoihandle_t cnv, uint32 wake_tick);
 	sync_list_t<gebaeude_t> sync_buildings; ///< animated buildings
 	sync_list_t<roadsign_t> sync_roadsigns; ///< traffic lights
 
@@ -1112,6 +1225,24 @@ public:
 	 */
 	void step();
 
+	/**
+	 * Steps all factories: first the production of all, in parallel if there are many,
+	 * then the distribution of the goods one after another.
+	 */
+	void step_factories(uint32 delta_t);
+#ifdef MULTI_THREAD
+	static void *step_factories_thread(void *);
+#endif
+
+	/**
+	 * Calls player_t::plan() of all players which want to plan in this step,
+	 * on worker threads if there are several of them.
+	 */
+	void plan_players();
+#ifdef MULTI_THREAD
+	static void *plan_player_thread(void *);
+#endif
+
 public:
 	/**
 	* Calculates appropriate climate for a region using elliptic areas for each
@@ -52,6 +52,75 @@ surface_t::surface_t() :
 
 surface_t::~surface_t()
 {
+	free_tile_info();
+}
+
+
+void surface_t::init_tile_info()
+{
+	free_tile_info();
+
+	const uint32 count = (uint32)cached_grid_size.x * cached_grid_size.y;
+	if(  plan == NULL  ||  count == 0  ) {
+		return;
+	}
+	ground_hgts = new sint8[count];
+	ground_slopes = new uint8[count];
+	tile_flags = new uint8[count];
+
+	koord k;
+	for(  k.y = 0;  k.y < cached_grid_size.y;  k.y++  ) {
+		for(  k.x = 0;  k.x < cached_grid_size.x;  k.x++  ) {
+			update_tile_info(k);
+		}
+	}
+}
+
+
+void surface_t::free_tile_info()
+{
+	delete [] ground_hgts;
+	ground_hgts = NULL;
+	delete [] ground_slopes;
+	ground_slopes = NULL;
+	delete [] tile_flags;
+	tile_flags = NULL;
+}
+
+
+void surface_t::update_tile_info(koord k)
+{
+	// during map creation, rotation and destruction there is nothing to update
+	if(  tile_flags == NULL  ||  !is_within_limits(k)  ) {
+		return;
+	}
+
+	const uint32 nr = k.x + k.y * cached_grid_size.x;
+	const planquadrat_t &pl = plan[nr];
+	uint8 flags = pl.get_climate();
+
+	if(  const grund_t *gr = pl.get_kartenboden()  ) {
+		ground_hgts[nr] = gr->get_hoehe();
+		ground_slopes[nr] = gr->get_grund_hang();
+		if(  gr->is_water()  ) {
+			flags |= TILE_WATER;
+		}
+		if(  gr->hat_wege()  ) {
+			flags |= TILE_WAYS;
+		}
+		if(  gr->ist_natur()  ) {
+			flags |= TILE_NATURE;
+		}
+		if(  pl.get_boden_count() > 1  ) {
+			flags |= TILE_MORE_GROUNDS;
+		}
+	}
+	else {
+		// not yet initialised
+		ground_hgts[nr] = groundwater;
+		ground_slopes[nr] = slope_t::flat;
+	}
+	tile_flags[nr] = flags;
 }
 
 
@@ -85,23 +154,24 @@ bool surface_t::square_is_free(koord pos, sint16 w, sint16 h, int *last_y, clima
 		return false;
 	}
 
-	grund_t *gr = lookup_kartenboden(pos);
-	const sint16 platz_base_h = gr->get_hoehe(); // remember the base height of the first tile
-	const sint16 platz_max_h = gr->get_hoehe() + slope_t::max_diff( gr->get_grund_hang() ); // remember the max height of the first tile
+	// remember the base height and the max height of the first tile
+	const sint16 platz_base_h = get_ground_hgt_nocheck(pos);
+	const sint16 platz_max_h = platz_base_h + slope_t::max_diff( get_ground_slope_nocheck(pos) );
 
 	koord k_check;
 	for(k_check.x=pos.x; k_check.x<pos.x+w; k_check.x++) {
 		for(k_check.y=pos.y+h-1; k_check.y>=pos.y; k_check.y--) {
-			const grund_t *gr = lookup_kartenboden(k_check);
-
-			// we can built, if: max height all the same, everything removable and no buildings there
-			slope_t::type slope = gr->get_grund_hang();
-			sint8 max_height = gr->get_hoehe() + slope_t::max_diff(slope);
-			climate test_climate = get_climate(k_check);
+			// first the checks, which only need the tile info
+			const uint8 flags = get_tile_flags_nocheck(k_check);
+			const sint8 hgt = get_ground_hgt_nocheck(k_check);
+			const slope_t::type slope = get_ground_slope_nocheck(k_check);
+			const sint8 max_height = hgt + slope_t::max_diff(slope);
+			climate test_climate = (climate)(flags & TILE_CLIMATE_MASK);
 			if(  cl & (1 << water_climate)  &&  test_climate != water_climate  ) {
 				bool neighbour_water = false;
 				for(int i=0; i<8  &&  !neighbour_water; i++) {
-					if(  is_within_limits(k_check + koord::neighbours[i])  &&  get_climate( k_check + koord::neighbours[i] ) == water_climate  ) {
+					const koord k_neighbour = k_check + koord::neighbours[i];
+					if(  is_within_limits(k_neighbour)  &&  get_tile_climate_nocheck(k_neighbour) == water_climate  ) {
 						neighbour_water = true;
 					}
 				}
@@ -109,9 +179,18 @@ bool surface_t::square_is_free(koord pos, sint16 w, sint16 h, int *last_y, clima
 					test_climate = water_climate;
 				}
 			}
-			if( (platz_max_h != max_height  &&  platz_base_h != gr->get_hoehe())  ||  !gr->ist_natur()  ||  gr->kann_alle_obj_entfernen(NULL) != NULL  ||
-			     (cl & (1 << test_climate)) == 0  ||  ( slope && (lookup( gr->get_pos()+koord3d(0,0,1) ) ||
-			     (slope_t::max_diff(slope)==2 && lookup( gr->get_pos()+koord3d(0,0,2) )) ))  ) {
+
+			// we can built, if: max height all the same, everything removable and no buildings there
+			bool ok = (platz_max_h == max_height  ||  platz_base_h == hgt)  &&  (flags & TILE_NATURE)  &&  (cl & (1 << test_climate)) != 0;
+			if(  ok  &&  slope  &&  (flags & TILE_MORE_GROUNDS)  ) {
+				// no bridge or elevated way directly above the slope
+				const koord3d gr_pos( k_check, hgt );
+				ok = !lookup( gr_pos+koord3d(0,0,1) )  &&  !(slope_t::max_diff(slope)==2 && lookup( gr_pos+koord3d(0,0,2) ));
+			}
+			if(  ok  ) {
+				ok = lookup_kartenboden_nocheck(k_check)->kann_alle_obj_entfernen(NULL) == NULL;
+			}
+			if(  !ok  ) {
 				if(  last_y  ) {
 					*last_y = k_check.y;
 				}
@@ -747,6 +826,7 @@ void surface_t::calc_climate(koord k, bool recalc)
 		}
 		pl->set_climate_transition_flag(false);
 		pl->set_climate_corners(0);
+		update_tile_info(k);
 	}
 
 	if(  recalc  ) {
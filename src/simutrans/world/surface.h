@@ -89,6 +89,16 @@ protected:
 	 * @see cached_grid_size
 	 */
 	sint8 *water_hgts = NULL;
+
+	/**
+	 * Copies of the height, slope and some flags of the ground (kartenboden) of each tile,
+	 * so scans over many tiles need not follow the pointers to the grund_t objects.
+	 * Updated by grund_t and planquadrat_t on every change, see update_tile_info().
+	 * @see cached_size
+	 */
+	sint8 *ground_hgts = NULL;
+	uint8 *ground_slopes = NULL;
+	uint8 *tile_flags = NULL;
 	/** @} */
 
 	/// Table for fast conversion from height to climate.
@@ -103,6 +113,16 @@ protected:
 	/// (needed to restore tiles after height changes)
 	array2d_tpl<uint8> humidity_map;
 
+public:
+	/// The bits of tile_flags
+	enum tile_flag_t {
+		TILE_CLIMATE_MASK  = 7,      ///< climate of the tile
+		TILE_WATER         = 1 << 3, ///< ground is water
+		TILE_WAYS          = 1 << 4, ///< ground has ways
+		TILE_NATURE        = 1 << 5, ///< ground is boden_t without ways and halts, see grund_t::ist_natur()
+		TILE_MORE_GROUNDS  = 1 << 6  ///< there are bridges or tunnels on this tile
+	};
+
 public:
 	surface_t();
 	~surface_t();
@@ -322,6 +342,32 @@ public:
 
 	inline void set_water_hgt_nocheck(koord k, sint8 hgt) { water_hgts[k.x + k.y * cached_grid_size.x] = hgt; }
 
+public:
+	/**
+	 * @name Copies of the ground data of a tile
+	 *       Faster than lookup_kartenboden() for scans over many tiles.
+	 *       For speed no checks are performed that coordinates are valid.
+	 * @{
+	 */
+	inline sint8 get_ground_hgt_nocheck(koord k) const { return ground_hgts[k.x + k.y * cached_grid_size.x]; }
+
+	inline slope_t::type get_ground_slope_nocheck(koord k) const { return (slope_t::type)ground_slopes[k.x + k.y * cached_grid_size.x]; }
+
+	/// @returns the tile_flag_t bits of the tile
+	inline uint8 get_tile_flags_nocheck(koord k) const { return tile_flags[k.x + k.y * cached_grid_size.x]; }
+
+	inline climate get_tile_climate_nocheck(koord k) const { return (climate)(get_tile_flags_nocheck(k) & TILE_CLIMATE_MASK); }
+	/** @} */
+
+	/// Copies the data of the ground at @p k again, must be called after every change of it
+	void update_tile_info(koord k);
+
+protected:
+	/// (Re)allocates the tile info for the current map size and fills it from all tiles
+	void init_tile_info();
+
+	void free_tile_info();
+
 public:
 	/**
 	 * Returns the current waterline height.
@@ -485,6 +531,7 @@ public:
 		planquadrat_t *plan = access(k);
 		if(  plan  ) {
 			plan->set_climate(cl);
+			update_tile_info(k);
 			if(  recalc  ) {
 				recalc_transitions(k);
 				for(  int i = 0;  i < 8;  i++  ) {
@@ -621,8 +621,9 @@ const char *terraformer_t::can_lower_plan_to(const player_t *player, sint16 x, s
 		return "";
 	}
 
-	const sint8 hmax = plan->get_kartenboden()->get_hoehe();
-	if(  (hmax == h  ||  hmax == h - 1)  &&  (plan->get_kartenboden()->get_grund_hang() == 0  ||  welt->is_plan_height_changeable( x, y ))  ) {
+	const koord k(x,y);
+	const sint8 hmax = welt->get_ground_hgt_nocheck(k);
+	if(  (hmax == h  ||  hmax == h - 1)  &&  (welt->get_ground_slope_nocheck(k) == 0  ||  welt->is_plan_height_changeable( x, y ))  ) {
 		return NULL;
 	}
 
@@ -645,11 +646,13 @@ const char *terraformer_t::can_lower_plan_to(const player_t *player, sint16 x, s
 	}
 
 	// tunnel below?
-	while(h < hmax) {
-		if(plan->get_boden_in_hoehe(h)) {
-			return "";
+	if(  welt->get_tile_flags_nocheck(k) & surface_t::TILE_MORE_GROUNDS  ) {
+		while(h < hmax) {
+			if(plan->get_boden_in_hoehe(h)) {
+				return "";
+			}
+			h ++;
 		}
-		h ++;
 	}
 
 	// check allowance by scenario
@@ -669,12 +672,14 @@ const char *terraformer_t::can_raise_plan_to(const player_t *player, sint16 x, s
 	}
 
 	// irgendwo eine Bruecke im Weg?
-	const sint8 hmin = plan->get_kartenboden()->get_hoehe();
-	while(h > hmin) {
-		if(plan->get_boden_in_hoehe(h)) {
-			return "";
+	if(  welt->get_tile_flags_nocheck(koord(x,y)) & surface_t::TILE_MORE_GROUNDS  ) {
+		const sint8 hmin = welt->get_ground_hgt_nocheck(koord(x,y));
+		while(h > hmin) {
+			if(plan->get_boden_in_hoehe(h)) {
+				return "";
+			}
+			h --;
 		}
-		h --;
 	}
 
 	// check allowance by scenario
@@ -101,6 +101,11 @@ SQRESULT sq_get_ops_total(HSQUIRRELVM v)
 	return 1;
 }
 
+SQInteger sq_get_ops_executed(HSQUIRRELVM v)
+{
+	return v->_ops_total;
+}
+
 SQRESULT sq_get_ops_remaing(HSQUIRRELVM v)
 {
 	sq_pushinteger(v, v->_ops_remaining);
@@ -71,4 +71,7 @@ SQRESULT sq_get_ops_total(HSQUIRRELVM v);
 /// @returns amount of remaining opcodes until vm will be suspended
 SQRESULT sq_get_ops_remaing(HSQUIRRELVM v);
 
+/// @returns total amount of opcodes executed by vm, does not push anything
+SQInteger sq_get_ops_executed(HSQUIRRELVM v);
+
 #endif
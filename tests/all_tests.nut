@@ -215,6 +215,7 @@ all_tests <- [
 	test_way_road_cityroad_replace_keep_existing,
 	test_way_road_has_double_slopes,
 	test_way_road_make_public,
+	test_way_road_area_maps,
 	test_way_runway_build_rw_flat,
 	test_way_runway_build_tw_flat,
 	test_way_runway_build_mixed_flat,
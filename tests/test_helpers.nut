@@ -28,6 +28,15 @@ function ASSERT_EQUAL(act, exp)
 	}
 }
 
+// compares arrays element by element
+function ASSERT_ARRAY_EQUAL(act, exp)
+{
+	ASSERT_EQUAL(act.len(), exp.len())
+	foreach (i, val in exp) {
+		ASSERT_EQUAL(act[i], val)
+	}
+}
+
 function ASSERT_LESS(lhs, rhs)
 {
 	if (!(lhs < rhs)) {
@@ -1298,3 +1298,86 @@ function test_way_road_make_public()
 	ASSERT_EQUAL(wayremover.work(public_pl, coord3d(4, 2, 0), coord3d(4, 4, 0), "" + wt_road), null)
 	RESET_ALL_PLAYER_FUNDS()
 }
+
+
+function test_way_road_area_maps()
+{
+	local pl = player_x(0)
+	local wayremover = command_x(tool_remove_way)
+	local road_desc  = way_desc_x.get_available_ways(wt_road, st_flat)[0]
+
+	ASSERT_EQUAL(command_x.build_way(pl, coord3d(2, 1, 0), coord3d(2, 3, 0), road_desc, true), null)
+
+	// 3x3 area around the road, stored row by row
+	{
+		ASSERT_ARRAY_EQUAL(world.get_way_dirs_map(coord(1, 1), coord(3, 3), wt_road),
+			[ 0, dir.south, 0,
+			  0, dir.northsouth, 0,
+			  0, dir.north, 0 ])
+		ASSERT_ARRAY_EQUAL(world.get_way_dirs_map(coord(1, 1), coord(3, 3), wt_rail), [ 0, 0, 0, 0, 0, 0, 0, 0, 0 ])
+
+		ASSERT_ARRAY_EQUAL(world.get_owner_map(coord(1, 1), coord(3, 3)),
+			[ 15, 0, 15,
+			  15, 0, 15,
+			  15, 0, 15 ])
+		ASSERT_ARRAY_EQUAL(world.get_height_map(coord(3, 3), coord(1, 1)), [ 0, 0, 0, 0, 0, 0, 0, 0, 0 ])
+		ASSERT_ARRAY_EQUAL(world.get_halt_map(coord(1, 1), coord(3, 3)), [ 0, 0, 0, 0, 0, 0, 0, 0, 0 ])
+	}
+
+	// native route search
+	{
+		local planner = way_planner_x(pl)
+		planner.set_build_types(road_desc)
+
+		local route = planner.calc_route(coord3d(2, 3, 0), coord3d(5, 3, 0))
+		ASSERT_EQUAL(route.len(), 4)
+	}
+
+	// a halt on the road shows up in the halt map and the halt statistics
+	{
+		local station_desc = building_desc_x.get_available_stations(building_desc_x.station, wt_road, {})[0]
+		ASSERT_EQUAL(command_x(tool_build_station).work(pl, coord3d(2, 2, 0), station_desc.get_name()), null)
+
+		local halt = halt_x.get_halt(coord3d(2, 2, 0), pl)
+		ASSERT_TRUE(halt != null)
+		ASSERT_ARRAY_EQUAL(world.get_halt_map(coord(1, 1), coord(3, 3)),
+			[ 0, 0, 0,
+			  0, halt.id, 0,
+			  0, 0, 0 ])
+
+		local list = halt_list_x()
+		local waiting = list.get_waiting(0)
+		local convoys = list.get_convoys(0)
+		ASSERT_EQUAL(waiting.len(), list.get_count())
+		ASSERT_EQUAL(convoys.len(), list.get_count())
+		foreach (i, h in list) {
+			if (h.id == halt.id) {
+				ASSERT_EQUAL(waiting[i], halt.get_waiting()[0])
+				ASSERT_EQUAL(convoys[i], halt.get_convoys()[0])
+			}
+		}
+		ASSERT_EQUAL(list.get_waiting(100).len(), 0) // invalid month
+
+		ASSERT_EQUAL(command_x(tool_remover).work(pl, coord3d(2, 2, 0)), null)
+		ASSERT_ARRAY_EQUAL(world.get_halt_map(coord(1, 1), coord(3, 3)), [ 0, 0, 0, 0, 0, 0, 0, 0, 0 ])
+	}
+
+	// a factory next to the road shows up in the factory statistics
+	{
+		local public_pl = player_x(1)
+		ASSERT_EQUAL(build_factory(public_pl, coord3d(3, 4, 0), 0, 1, 1024, "Aufwindkraftwerk"), null)
+		local factory = factory_x(3, 4)
+
+		local list = factory_list_x()
+		ASSERT_EQUAL(list.get_count(), 1)
+		ASSERT_ARRAY_EQUAL(list.get_production(0), [ factory.get_production()[0] ])
+		ASSERT_ARRAY_EQUAL(list.get_power(0),      [ factory.get_power()[0] ])
+		ASSERT_ARRAY_EQUAL(list.get_pax_generated(1), [ factory.get_pax_generated()[1] ])
+
+		ASSERT_EQUAL(command_x(tool_remover).work(public_pl, coord3d(3, 4, 0)), null)
+		ASSERT_EQUAL(factory_list_x().get_production(0).len(), 0)
+	}
+
+	ASSERT_EQUAL(wayremover.work(pl, coord3d(2, 1, 0), coord3d(2, 3, 0), "" + wt_road), null)
+	RESET_ALL_PLAYER_FUNDS()
+}